@@ -1,17 +1,104 @@
 #pragma once
 
+#include <deque>
+#include <iostream>
+#include <string>
 #include "base.hpp"
+#include "assets/asset_pack.hpp"
 
 GGJ16_NAMESPACE
 {
+    /// @brief Boot assets, loaded synchronously: from the asset pack when
+    /// it is valid, else from `data/assets.json` and loose files. Assets
+    /// missing from the pack, or malformed in it, are also loaded from
+    /// loose files.
     struct asset_loader
     {
+        template <typename T>
+        struct tag
+        {
+        };
+
         ssvs::AssetManager<> _asset_manager;
+        bool _loose_loaded{false};
+        const asset_pack::reader& _pack;
+
+        // Assets created from the pack. Deques keep their addresses stable.
+        std::deque<sf::Texture> _textures;
+        std::deque<ssvs::BitmapFont> _fonts;
+
+        /// @brief Returns `nullptr` if `e` is not a well-formed texture.
+        sf::Texture* packed_texture(const asset_pack::entry& e)
+        {
+            if(e._kind != asset_pack::entry_kind::texture) return nullptr;
+
+            asset_pack::buffer scratch;
+            auto pixels(_pack.pixels(e, scratch));
+            if(pixels == nullptr) return nullptr;
+
+            _textures.emplace_back();
+            if(!_textures.back().create(e._params[0], e._params[1]))
+                return nullptr;
+
+            _textures.back().update(pixels);
+            return &_textures.back();
+        }
+
+        /// @brief Loads `name` from the loose files.
+        template <typename T>
+        auto& loose(const std::string& name)
+        {
+            if(_pack.valid())
+            {
+                std::cerr << "assets.pak: missing or malformed \"" << name
+                          << "\", loading the loose file\n";
+            }
+
+            if(!_loose_loaded)
+            {
+                _loose_loaded = true;
+                ssvs::loadAssetsFromJson(_asset_manager, "data/",
+                    ssvj::fromFile("data/assets.json"));
+            }
+
+            return _asset_manager.get<T>(name);
+        }
+
+        auto& get_impl(tag<sf::Texture>, const std::string& name)
+        {
+            auto e(_pack.find(asset_pack::entry_kind::texture, name));
+            auto texture(e != nullptr ? packed_texture(*e) : nullptr);
+
+            if(texture == nullptr) return loose<sf::Texture>(name);
+            return *texture;
+        }
+
+        auto& get_impl(tag<ssvs::BitmapFont>, const std::string& name)
+        {
+            auto e(_pack.find(asset_pack::entry_kind::font, name));
+            if(e == nullptr || e->_params[0] >= _pack.entries().size())
+                return loose<ssvs::BitmapFont>(name);
+
+            auto texture(packed_texture(_pack.at(e->_params[0])));
+            if(texture == nullptr) return loose<ssvs::BitmapFont>(name);
+
+            std::string metrics{
+                reinterpret_cast<const char*>(_pack.data(*e)), e->_size};
+
+            _fonts.emplace_back(*texture,
+                ssvj::fromStr(metrics).as<ssvs::BitmapFontData>());
+            return _fonts.back();
+        }
+
+        inline asset_loader(const asset_pack::reader& pack) noexcept
+            : _pack(pack)
+        {
+        }
 
-        inline asset_loader()
+        template <typename T>
+        auto& get(const std::string& name)
         {
-            ssvs::loadAssetsFromJson(
-                _asset_manager, "data/", ssvj::fromFile("data/assets.json"));
+            return get_impl(tag<T>{}, name);
         }
     };
 }
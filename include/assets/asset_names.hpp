@@ -0,0 +1,44 @@
+#pragma once
+
+#include "base.hpp"
+
+// Asset lists, shared by `impl::assets`, which declares one member per name,
+// and the asset tools, which pack the matching files. Names are identifiers;
+// files are `<name><extension>` in the data directory.
+
+#define GGJ16_ASSET_FONTS fontObStroked, fontObBig
+
+#define GGJ16_ASSET_TEXTURES title
+
+#define GGJ16_ASSET_REGIONS landscape, d0, d1, d2, d3, bar
+
+#define GGJ16_ASSET_SOUNDS                                                  \
+    click0, enemy_atk0, enemy_atk1, msgbox, shield_up, fireball, obliterate, \
+        success, failure, scripted_text, blip, bip
+
+#define GGJ16_ASSET_NAME_IMPL(mIdx, mData, mArg) VRM_PP_TOSTR(mArg) mData,
+
+/// @brief String literals `"<name><mExt>"`, comma separated.
+#define GGJ16_ASSET_NAMES(mExt, ...) \
+    VRM_PP_FOREACH_REVERSE(GGJ16_ASSET_NAME_IMPL, mExt, __VA_ARGS__)
+
+GGJ16_NAMESPACE
+{
+    namespace asset_names
+    {
+        constexpr const char* fonts[]{GGJ16_ASSET_NAMES("", GGJ16_ASSET_FONTS)};
+
+        constexpr const char* textures[]{
+            GGJ16_ASSET_NAMES(".png", GGJ16_ASSET_TEXTURES)};
+
+        constexpr const char* regions[]{
+            GGJ16_ASSET_NAMES("", GGJ16_ASSET_REGIONS)};
+
+        constexpr const char* sounds[]{
+            GGJ16_ASSET_NAMES(".ogg", GGJ16_ASSET_SOUNDS)};
+
+        /// @brief Read with `assets().read_data`.
+        constexpr const char* data_files[]{"rituals.json"};
+    }
+}
+GGJ16_NAMESPACE_END
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "base.hpp"
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary asset pack, built by `ggj2016_pack`. Stored in native byte order,
+// as a build artifact of the target platform:
+//
+//     pack := header entry[entry_count] blob*
+//
+// Entries have a fixed size and every blob is `blob_alignment`-aligned, so
+// the file is used in place once memory-mapped: raw texture pixels are
+// uploaded straight from the mapping.
+//
+//     texture: RGBA8 pixels, `raw` or `rle`; params: width, height
+//     sound:   the original encoded file
+//     font:    BitmapFont metrics JSON; params: texture entry index
+//     region:  atlas region; params: page entry index, x, y, w, h
+//     data:    any other file, read as-is
+
+GGJ16_NAMESPACE
+{
+    namespace asset_pack
+    {
+        constexpr char magic[]{'G', 'G', 'J', '1', '6', 'P', 'A', 'K'};
+        constexpr sz_t magic_size{sizeof(magic)};
+        constexpr std::uint32_t version{1};
+
+        constexpr sz_t name_size{48};
+        constexpr sz_t param_count{6};
+        constexpr sz_t blob_alignment{16};
+
+        enum class entry_kind : std::uint32_t
+        {
+            texture,
+            sound,
+            font,
+            region,
+            data
+        };
+
+        enum class codec : std::uint32_t
+        {
+            raw,
+            rle
+        };
+
+        struct header
+        {
+            char _magic[magic_size];
+            std::uint32_t _version;
+            std::uint32_t _entry_count;
+        };
+
+        struct entry
+        {
+            char _name[name_size];
+            entry_kind _kind;
+            codec _codec;
+            std::uint64_t _offset;
+            std::uint64_t _size;
+            std::uint32_t _params[param_count];
+
+            auto name() const { return std::string{_name}; }
+        };
+
+        using buffer = std::vector<std::uint8_t>;
+
+        /// @brief Run-length coding of 32-bit pixels. A control byte `c`
+        /// is followed either by one pixel repeated `(c & 0x7F) + 1` times
+        /// (high bit set), or by `c + 1` literal pixels.
+        namespace rle
+        {
+            constexpr sz_t pixel_size{4};
+            constexpr sz_t max_run{128};
+
+            inline bool same_pixel(const std::uint8_t* a, const std::uint8_t* b)
+            {
+                return std::memcmp(a, b, pixel_size) == 0;
+            }
+
+            inline void encode(
+                const std::uint8_t* pixels, sz_t pixel_count, buffer& out)
+            {
+                auto px([pixels](sz_t i)
+                    {
+                        return pixels + i * pixel_size;
+                    });
+
+                sz_t i{0};
+                while(i < pixel_count)
+                {
+                    sz_t run{1};
+                    while(i + run < pixel_count && run < max_run &&
+                          same_pixel(px(i), px(i + run)))
+                        ++run;
+
+                    if(run > 1)
+                    {
+                        out.emplace_back(std::uint8_t(0x80 | (run - 1)));
+                        out.insert(std::end(out), px(i), px(i) + pixel_size);
+                        i += run;
+                        continue;
+                    }
+
+                    // Literals, up to the start of the next run.
+                    sz_t lit{1};
+                    while(i + lit < pixel_count && lit < max_run &&
+                          !(i + lit + 1 < pixel_count &&
+                              same_pixel(px(i + lit), px(i + lit + 1))))
+                        ++lit;
+
+                    out.emplace_back(std::uint8_t(lit - 1));
+                    out.insert(std::end(out), px(i), px(i + lit));
+                    i += lit;
+                }
+            }
+
+            /// @brief Returns false on malformed or truncated input.
+            inline bool decode(const std::uint8_t* data, sz_t size,
+                std::uint8_t* pixels, sz_t pixel_count)
+            {
+                const auto end(data + size);
+                const auto out_end(pixels + pixel_count * pixel_size);
+
+                while(data < end)
+                {
+                    auto c(*data++);
+                    auto n(sz_t(c & 0x7F) + 1);
+
+                    if(pixels + n * pixel_size > out_end) return false;
+
+                    if(c & 0x80)
+                    {
+                        if(sz_t(end - data) < pixel_size) return false;
+
+                        for(sz_t k(0); k < n; ++k, pixels += pixel_size)
+                            std::memcpy(pixels, data, pixel_size);
+
+                        data += pixel_size;
+                    }
+                    else
+                    {
+                        if(sz_t(end - data) < n * pixel_size) return false;
+
+                        std::memcpy(pixels, data, n * pixel_size);
+                        pixels += n * pixel_size;
+                        data += n * pixel_size;
+                    }
+                }
+
+                return pixels == out_end;
+            }
+        }
+
+        /// @brief Read-only view of a whole file: a memory mapping where
+        /// available, a plain copy elsewhere. Empty if the file is missing.
+        class mapped_file
+        {
+        private:
+            const std::uint8_t* _data{nullptr};
+            sz_t _size{0};
+
+#if defined(_WIN32)
+            buffer _copy;
+
+            void open(const std::string& path)
+            {
+                std::ifstream is{path, std::ios::binary};
+                if(!is) return;
+
+                _copy.assign(std::istreambuf_iterator<char>{is},
+                    std::istreambuf_iterator<char>{});
+
+                _data = _copy.data();
+                _size = _copy.size();
+            }
+
+            void close() {}
+#else
+            void open(const std::string& path)
+            {
+                auto fd(::open(path.c_str(), O_RDONLY));
+                if(fd < 0) return;
+
+                struct stat st;
+                if(::fstat(fd, &st) == 0 && st.st_size > 0)
+                {
+                    auto p(::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE,
+                        fd, 0));
+
+                    if(p != MAP_FAILED)
+                    {
+                        _data = static_cast<const std::uint8_t*>(p);
+                        _size = st.st_size;
+                    }
+                }
+
+                ::close(fd);
+            }
+
+            void close()
+            {
+                if(_data != nullptr)
+                    ::munmap(const_cast<std::uint8_t*>(_data), _size);
+            }
+#endif
+
+        public:
+            mapped_file(const std::string& path) { open(path); }
+            ~mapped_file() { close(); }
+
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            const auto& data() const noexcept { return _data; }
+            const auto& size() const noexcept { return _size; }
+        };
+
+        /// @brief Validated index of a mapped pack. An invalid (or
+        /// missing) pack has no entries.
+        class reader
+        {
+        private:
+            mapped_file _file;
+            std::vector<entry> _entries;
+
+            void read_index()
+            {
+                header h;
+                if(_file.size() < sizeof(h)) return;
+
+                std::memcpy(&h, _file.data(), sizeof(h));
+                if(std::memcmp(h._magic, magic, magic_size) != 0 ||
+                    h._version != version)
+                    return;
+
+                auto index_size(sz_t(h._entry_count) * sizeof(entry));
+                if(sizeof(h) + index_size > _file.size()) return;
+
+                _entries.resize(h._entry_count);
+                std::memcpy(_entries.data(), _file.data() + sizeof(h),
+                    _entries.size() * sizeof(entry));
+
+                for(auto& e : _entries)
+                {
+                    e._name[name_size - 1] = '\0';
+
+                    if(e._offset > _file.size() ||
+                        e._size > _file.size() - e._offset)
+                    {
+                        _entries.clear();
+                        return;
+                    }
+                }
+            }
+
+        public:
+            reader(const std::string& path) : _file{path} { read_index(); }
+
+            auto valid() const noexcept { return !_entries.empty(); }
+
+            const auto& entries() const noexcept { return _entries; }
+
+            const entry* find(entry_kind k, const std::string& name) const
+            {
+                for(const auto& e : _entries)
+                    if(e._kind == k && name == e._name) return &e;
+
+                return nullptr;
+            }
+
+            const auto& at(sz_t i) const noexcept
+            {
+                VRM_CORE_ASSERT_OP(i, <, _entries.size());
+                return _entries[i];
+            }
+
+            const std::uint8_t* data(const entry& e) const noexcept
+            {
+                return _file.data() + e._offset;
+            }
+
+            /// @brief RGBA pixels of texture `e`: in place for `raw`, else
+            /// decoded into `scratch`. `nullptr` if the entry is malformed.
+            const std::uint8_t* pixels(const entry& e, buffer& scratch) const
+            {
+                VRM_CORE_ASSERT(e._kind == entry_kind::texture);
+
+                auto count(sz_t(e._params[0]) * e._params[1]);
+
+                if(e._codec == codec::raw)
+                    return e._size == count * rle::pixel_size ? data(e)
+                                                              : nullptr;
+
+                scratch.resize(count * rle::pixel_size);
+                return rle::decode(data(e), e._size, scratch.data(), count)
+                           ? scratch.data()
+                           : nullptr;
+            }
+        };
+    }
+}
+GGJ16_NAMESPACE_END
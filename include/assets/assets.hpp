@@ -1,11 +1,21 @@
 #pragma once
 
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
 #include "base.hpp"
 #include "assets/asset_loader.hpp"
+#include "assets/asset_names.hpp"
+#include "assets/asset_pack.hpp"
+#include "assets/async_loader.hpp"
+#include "assets/sound_group.hpp"
+#include "assets/texture_atlas.hpp"
+#include "assets/voice_pool.hpp"
 
 #define CACHE_ASSET_IMPL(mType, mName, mExt) \
-    mType* mName{                            \
-        &_asset_loader._asset_manager.get<mType>(VRM_PP_TOSTR(mName) mExt)};
+    mType* mName{&_asset_loader.get<mType>(VRM_PP_TOSTR(mName) mExt)};
 
 #define CACHE_ASSETS_FOR_IMPL(mIdx, mData, mArg) \
     CACHE_ASSET_IMPL(VRM_PP_TPL_ELEM(mData, 0), mArg, VRM_PP_TPL_ELEM(mData, 1))
@@ -14,29 +24,69 @@
     VRM_PP_FOREACH_REVERSE(            \
         CACHE_ASSETS_FOR_IMPL, VRM_PP_TPL_MAKE(mType, mExt), __VA_ARGS__)
 
+#define CACHE_SOUND_IMPL(mIdx, mData, mArg)               \
+    sf::SoundBuffer* mArg{&name_sound(VRM_PP_TOSTR(mArg), \
+        _loader.sound_buffer(VRM_PP_TOSTR(mArg) ".ogg"))};
+
+#define CACHE_SOUNDS(...) \
+    VRM_PP_FOREACH_REVERSE(CACHE_SOUND_IMPL, _, __VA_ARGS__)
+
+#define CACHE_SOUND_GROUP(mName, ...) \
+    sound_group<VRM_PP_ARGCOUNT(__VA_ARGS__)> mName{{{__VA_ARGS__}}};
+
+#define CACHE_REGION_IMPL(mIdx, mData, mArg) \
+    texture_region mArg{_atlas.region(VRM_PP_TOSTR(mArg))};
+
+#define CACHE_REGIONS(...) \
+    VRM_PP_FOREACH_REVERSE(CACHE_REGION_IMPL, _, __VA_ARGS__)
+
 GGJ16_NAMESPACE
 {
     namespace impl
     {
         struct assets
         {
-            asset_loader _asset_loader;
+            // Optional, see `tools/pack.cpp`. Without it, assets are loaded
+            // from loose files in `data/`.
+            asset_pack::reader _pack{"data/assets.pak"};
 
-            // Audio players
-            ssvs::SoundPlayer _sound_player;
-            ssvs::MusicPlayer _music_player;
+            // Boot assets (fonts, title), loaded synchronously.
+            asset_loader _asset_loader{_pack};
+
+            // Everything else, loaded in the background.
+            async_loader _loader{_pack, "data/"};
+
+            // Sound voices: 16 at once, for up to 32 distinct buffers
+            voice_pool<16, 32> _voices;
 
             // BitmapFonts
-            CACHE_ASSETS(ssvs::BitmapFont, "", fontObStroked, fontObBig)
+            CACHE_ASSETS(ssvs::BitmapFont, "", GGJ16_ASSET_FONTS)
 
             // Textures
-            CACHE_ASSETS(
-                sf::Texture, ".png", landscape, d0, d1, d2, d3, bar, title)
+            CACHE_ASSETS(sf::Texture, ".png", GGJ16_ASSET_TEXTURES)
+
+            // Atlas regions, see `tools/atlas.cpp`
+            texture_atlas _atlas{_loader, "data/atlas.json"};
+
+            CACHE_REGIONS(GGJ16_ASSET_REGIONS)
 
-            // Sounds
-            CACHE_ASSETS(sf::SoundBuffer, ".ogg", click0, enemy_atk0,
-                enemy_atk1, msgbox, shield_up, fireball, obliterate, success,
-                failure, scripted_text, blip, bip, music)
+            // Sounds, also looked up by name by data files
+            std::unordered_map<std::string, sf::SoundBuffer*> _named_sounds;
+
+            sf::SoundBuffer& name_sound(
+                const std::string& name, sf::SoundBuffer& s)
+            {
+                _named_sounds[name] = &s;
+                return s;
+            }
+
+            CACHE_SOUNDS(GGJ16_ASSET_SOUNDS)
+
+            // Sound groups, played with `psnd_one`
+            CACHE_SOUND_GROUP(enemy_atk, enemy_atk0, enemy_atk1)
+
+            // Music, streamed from disk by `game_app`
+            std::string music{"data/music.ogg"};
 
             /*
     std::vector<sf::SoundBuffer *> swordSnds, maceSnds, spearSnds;
@@ -59,24 +109,74 @@ GGJ16_NAMESPACE
                 }
                 */
 
-                _sound_player.setVolume(100.f);
-                _music_player.setVolume(100.f);
+                _voices.set_volume(100.f);
+
+                // Played every frame while hovering ritual points.
+                _voices.set_min_interval(*bip, 0.1f);
+
+                _loader.start();
+            }
+
+            /// @brief Uploads the background assets decoded so far. Call
+            /// once per frame, from the main thread.
+            void poll_loading() { _loader.poll(); }
+
+            auto loading_done() const noexcept { return _loader.done(); }
+
+            auto has_sound(const std::string& name) const
+            {
+                return _named_sounds.count(name) != 0;
+            }
+
+            /// @brief The sound cached as `name`, which must exist.
+            auto sound(const std::string& name) const
+            {
+                auto itr(_named_sounds.find(name));
+                VRM_CORE_ASSERT(itr != std::end(_named_sounds));
+                return itr->second;
+            }
+
+            /// @brief Contents of `data/<name>`, from the asset pack when it
+            /// has it. Reports unreadable files, and returns `""` for them.
+            auto read_data(const std::string& name) const
+            {
+                auto e(_pack.find(asset_pack::entry_kind::data, name));
+                if(e != nullptr)
+                {
+                    return std::string{
+                        reinterpret_cast<const char*>(_pack.data(*e)),
+                        e->_size};
+                }
+
+                std::ifstream is{"data/" + name};
+                if(!is)
+                {
+                    std::cerr << "Failed to read data file: " << name << "\n";
+                    return std::string{};
+                }
+
+                std::ostringstream oss;
+                oss << is.rdbuf();
+                return oss.str();
+            }
+            auto loading_progress() const noexcept
+            {
+                return _loader.progress();
             }
 
             template <typename T>
-            inline void psnd(T&& s, ssvs::SoundPlayer::Mode mMode =
-                                        ssvs::SoundPlayer::Mode::Overlap,
-                float mPitch = 1.f)
+            inline void psnd(T&& s,
+                sound_priority p = sound_priority::normal, float mPitch = 1.f)
             {
-                _sound_player.play(*s, mMode, mPitch);
+                _voices.play(*s, p, mPitch);
             }
 
-            template <typename... Ts>
-            inline void psnd_one(Ts... xs)
+            /// @brief Plays one sound of `g`, picked with `rng`. Used for
+            /// gameplay feedback, so it can steal the voices of other sounds.
+            template <sz_t TN>
+            inline void psnd_one(rng_t& rng, const sound_group<TN>& g)
             {
-                std::vector<std::common_type_t<Ts...>> v{xs...};
-                ssvu::shuffle(v);
-                psnd(v[0]);
+                psnd(g.pick(rng), sound_priority::high);
             }
         };
     }
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "base.hpp"
+#include "assets/asset_pack.hpp"
+#include "sim/work_stealing.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief Loads textures and sound buffers in the background. Requests
+    /// immediately return a stable reference to an empty placeholder.
+    /// `start` decodes every requested file on a thread pool. `poll`, called
+    /// from the main thread, uploads finished textures to the GPU and fills
+    /// the placeholders in place. Files found in the asset pack are read
+    /// from its mapping instead of the data directory, unless the packed
+    /// copy is malformed.
+    class async_loader
+    {
+    private:
+        enum class job_kind
+        {
+            texture,
+            sound_buffer
+        };
+
+        struct job
+        {
+            job_kind _kind;
+            std::string _path;
+            const asset_pack::reader* _pack{nullptr};
+            const asset_pack::entry* _entry{nullptr};
+            sf::Texture* _texture{nullptr};
+            sf::SoundBuffer* _sound_buffer{nullptr};
+
+            // Decoded data, handed over to the main thread.
+            sf::Image _image;
+            asset_pack::buffer _scratch;
+            const std::uint8_t* _pixels{nullptr};
+            std::vector<sf::Int16> _samples;
+            unsigned int _channel_count{0};
+            unsigned int _sample_rate{0};
+            bool _ok{false};
+
+            std::atomic<bool> _decoded{false};
+            bool _uploaded{false};
+
+            job(job_kind kind, const std::string& path)
+                : _kind{kind}, _path{path}
+            {
+            }
+
+            void decode()
+            {
+                if(_kind == job_kind::texture)
+                {
+                    // Packed pixels need no decoding unless compressed.
+                    if(_entry != nullptr)
+                    {
+                        _pixels = _pack->pixels(*_entry, _scratch);
+                        if(_pixels == nullptr) _entry = nullptr;
+                    }
+
+                    _ok = _entry != nullptr || _image.loadFromFile(_path);
+                }
+                else
+                {
+                    sf::InputSoundFile f;
+                    _ok = (_entry != nullptr &&
+                              f.openFromMemory(
+                                  _pack->data(*_entry), _entry->_size)) ||
+                          f.openFromFile(_path);
+
+                    if(_ok)
+                    {
+                        _samples.resize(f.getSampleCount());
+                        _channel_count = f.getChannelCount();
+                        _sample_rate = f.getSampleRate();
+                        _ok = f.read(_samples.data(), _samples.size()) ==
+                              _samples.size();
+                    }
+                }
+
+                _decoded.store(true, std::memory_order_release);
+            }
+
+            void upload()
+            {
+                _uploaded = true;
+
+                if(!_ok)
+                {
+                    std::cerr << "Failed to load asset: " << _path << "\n";
+                    return;
+                }
+
+                if(_kind == job_kind::texture && _entry != nullptr)
+                {
+                    _texture->create(_entry->_params[0], _entry->_params[1]);
+                    _texture->update(_pixels);
+                    asset_pack::buffer{}.swap(_scratch);
+                }
+                else if(_kind == job_kind::texture)
+                {
+                    _texture->loadFromImage(_image);
+                    _image = sf::Image{};
+                }
+                else
+                {
+                    _sound_buffer->loadFromSamples(_samples.data(),
+                        _samples.size(), _channel_count, _sample_rate);
+                    std::vector<sf::Int16>{}.swap(_samples);
+                }
+            }
+        };
+
+        // Deques keep placeholder addresses stable as requests are added.
+        std::deque<sf::Texture> _textures;
+        std::deque<sf::SoundBuffer> _sound_buffers;
+        std::vector<std::unique_ptr<job>> _jobs;
+
+        const asset_pack::reader& _pack;
+        std::string _data_dir;
+
+        std::thread _thread;
+        bool _started{false};
+        sz_t _uploaded{0};
+
+        auto& add_job(job_kind kind, asset_pack::entry_kind packed_kind,
+            const std::string& name)
+        {
+            VRM_CORE_ASSERT(!_started);
+
+            _jobs.emplace_back(std::make_unique<job>(kind, _data_dir + name));
+
+            auto& result(*_jobs.back());
+            result._pack = &_pack;
+            result._entry = _pack.find(packed_kind, name);
+            return result;
+        }
+
+    public:
+        async_loader(
+            const asset_pack::reader& pack, const std::string& data_dir)
+            : _pack(pack), _data_dir{data_dir}
+        {
+        }
+
+        async_loader(const async_loader&) = delete;
+        async_loader& operator=(const async_loader&) = delete;
+
+        ~async_loader()
+        {
+            if(_thread.joinable()) _thread.join();
+        }
+
+        const auto& pack() const noexcept { return _pack; }
+
+        /// @brief Requests `name`, relative to the data directory.
+        auto& texture(const std::string& name)
+        {
+            _textures.emplace_back();
+            add_job(job_kind::texture, asset_pack::entry_kind::texture, name)
+                ._texture = &_textures.back();
+            return _textures.back();
+        }
+
+        /// @brief Requests `name`, relative to the data directory.
+        auto& sound_buffer(const std::string& name)
+        {
+            _sound_buffers.emplace_back();
+            add_job(job_kind::sound_buffer, asset_pack::entry_kind::sound,
+                name)
+                ._sound_buffer = &_sound_buffers.back();
+            return _sound_buffers.back();
+        }
+
+        /// @brief Starts decoding every requested file. No more requests
+        /// can be made afterwards.
+        void start()
+        {
+            VRM_CORE_ASSERT(!_started);
+            _started = true;
+
+            _thread = std::thread([this]
+                {
+                    sim::work_stealing_pool pool;
+                    pool.run(_jobs.size(), [this](sz_t, sz_t i)
+                        {
+                            _jobs[i]->decode();
+                        });
+                });
+        }
+
+        auto done() const noexcept { return _uploaded == _jobs.size(); }
+
+        /// @brief Fraction of the assets uploaded, in `[0, 1]`.
+        auto progress() const noexcept
+        {
+            return _jobs.empty() ? 1.f : float(_uploaded) / _jobs.size();
+        }
+
+        /// @brief Uploads the assets decoded since the last call. Must be
+        /// called from the thread that owns the GL context.
+        void poll()
+        {
+            if(done()) return;
+
+            for(auto& j : _jobs)
+            {
+                if(j->_uploaded ||
+                    !j->_decoded.load(std::memory_order_acquire))
+                    continue;
+
+                j->upload();
+                ++_uploaded;
+            }
+        }
+    };
+}
+GGJ16_NAMESPACE_END
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <array>
+#include "base.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief Fixed set of interchangeable sounds, one of which is picked at
+    /// random whenever the group is played. Declared with
+    /// `CACHE_SOUND_GROUP`.
+    template <sz_t TN>
+    struct sound_group
+    {
+        VRM_CORE_STATIC_ASSERT_NM(TN > 0);
+
+        std::array<sf::SoundBuffer*, TN> _sounds;
+
+        auto pick(rng_t& rng) const noexcept
+        {
+            return _sounds[rng.index(TN)];
+        }
+    };
+}
+GGJ16_NAMESPACE_END
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "base.hpp"
+#include "assets/async_loader.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief A sub-rectangle of a texture: either a region of an atlas
+    /// page or, with an empty `_rect`, a whole loose texture.
+    struct texture_region
+    {
+        sf::Texture* _texture{nullptr};
+        sf::IntRect _rect;
+
+        /// @brief The whole texture's size is only known once it is
+        /// loaded, so it is looked up on use.
+        auto rect() const noexcept
+        {
+            VRM_CORE_ASSERT(_texture != nullptr);
+
+            if(_rect.width != 0) return _rect;
+
+            return sf::IntRect{0, 0, vrmc::to_int(_texture->getSize().x),
+                vrmc::to_int(_texture->getSize().y)};
+        }
+
+        void apply_to(sf::Sprite& s) const
+        {
+            s.setTexture(*_texture);
+            s.setTextureRect(rect());
+        }
+
+        auto make_sprite() const { return sf::Sprite{*_texture, rect()}; }
+    };
+
+    /// @brief Atlas pages and named regions produced by `ggj2016_atlas`,
+    /// read from the asset pack when it has them, else from the JSON index.
+    /// Names missing from the index, or a missing index altogether, fall
+    /// back to loading `<name>.png` as a loose texture. Pages and loose
+    /// textures are requested from an `async_loader`.
+    class texture_atlas
+    {
+    private:
+        async_loader& _loader;
+        std::unordered_map<std::string, texture_region> _regions;
+
+        bool load_packed()
+        {
+            const auto& pack(_loader.pack());
+            std::unordered_map<sz_t, sf::Texture*> pages;
+
+            for(const auto& e : pack.entries())
+            {
+                if(e._kind != asset_pack::entry_kind::region) continue;
+
+                // A region whose page is not a texture entry falls back
+                // to its loose texture.
+                auto page_idx(sz_t(e._params[0]));
+                if(page_idx >= pack.entries().size() ||
+                    pack.at(page_idx)._kind != asset_pack::entry_kind::texture)
+                {
+                    std::cerr << "assets.pak: region \"" << e.name()
+                              << "\" has no page " << page_idx << "\n";
+                    continue;
+                }
+
+                auto& page(pages[page_idx]);
+                if(page == nullptr)
+                    page = &_loader.texture(pack.at(page_idx).name());
+
+                _regions[e.name()] = texture_region{
+                    page, sf::IntRect{vrmc::to_int(e._params[1]),
+                              vrmc::to_int(e._params[2]),
+                              vrmc::to_int(e._params[3]),
+                              vrmc::to_int(e._params[4])}};
+            }
+
+            return !pages.empty();
+        }
+
+        void load_index(const std::string& index_path)
+        {
+            // The atlas is optional: keep using loose textures without it.
+            if(!std::ifstream{index_path}) return;
+
+            auto index(ssvj::fromFile(index_path));
+            std::vector<sf::Texture*> pages;
+
+            for(const auto& p : index["pages"].forArr())
+            {
+                auto file(p.as<std::string>());
+                pages.emplace_back(&_loader.texture(file));
+            }
+
+            for(const auto& r : index["regions"].forArr())
+            {
+                auto name(r["name"].as<std::string>());
+                auto page(r["page"].as<int>());
+
+                if(page < 0 || page >= vrmc::to_int(pages.size()))
+                {
+                    std::cerr << index_path << ": region \"" << name
+                              << "\" has no page " << page << "\n";
+                    continue;
+                }
+
+                _regions[name] = texture_region{
+                    pages[page], sf::IntRect{r["x"].as<int>(),
+                                     r["y"].as<int>(), r["w"].as<int>(),
+                                     r["h"].as<int>()}};
+            }
+        }
+
+    public:
+        /// @brief `index_path` is only read without a packed atlas.
+        texture_atlas(async_loader& loader, const std::string& index_path)
+            : _loader(loader)
+        {
+            if(!load_packed()) load_index(index_path);
+        }
+
+        auto region(const std::string& name)
+        {
+            auto itr(_regions.find(name));
+            if(itr != std::end(_regions)) return itr->second;
+
+            texture_region result{
+                &_loader.texture(name + ".png"), sf::IntRect{}};
+
+            _regions[name] = result;
+            return result;
+        }
+    };
+}
+GGJ16_NAMESPACE_END
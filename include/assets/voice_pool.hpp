@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "base.hpp"
+
+GGJ16_NAMESPACE
+{
+    enum class sound_priority : std::uint8_t
+    {
+        low,
+        normal,
+        high
+    };
+
+    /// @brief Fixed set of `sf::Sound` voices. Every buffer is rate limited
+    /// (replays closer than its minimum interval are dropped); when all
+    /// voices are busy, the oldest voice of the lowest priority not above
+    /// the new sound's is stolen. Rebinding a voice to another buffer may
+    /// allocate, so stopped voices already bound to the buffer go first.
+    template <sz_t TVoiceCount, sz_t TBufferCount>
+    class voice_pool
+    {
+    private:
+        using clock = std::chrono::steady_clock;
+
+        struct voice
+        {
+            sf::Sound _sound;
+            sound_priority _priority{sound_priority::low};
+            clock::time_point _started;
+        };
+
+        struct buffer_state
+        {
+            const sf::SoundBuffer* _buffer{nullptr};
+            clock::duration _min_interval;
+            clock::time_point _last_played;
+        };
+
+        std::array<voice, TVoiceCount> _voices;
+        std::array<buffer_state, TBufferCount> _buffers;
+        sz_t _buffer_count{0};
+        clock::duration _default_min_interval;
+        float _volume{100.f};
+
+        auto& state_of(const sf::SoundBuffer& b)
+        {
+            for(sz_t i(0); i < _buffer_count; ++i)
+                if(_buffers[i]._buffer == &b) return _buffers[i];
+
+            VRM_CORE_ASSERT_OP(_buffer_count, <, TBufferCount);
+
+            auto& result(_buffers[_buffer_count++]);
+            result._buffer = &b;
+            result._min_interval = _default_min_interval;
+            result._last_played = clock::time_point{};
+            return result;
+        }
+
+        /// @brief A stopped voice bound to `b`, else an unbound one, else
+        /// any stopped voice, else the one to steal for priority `p`, else
+        /// `nullptr`.
+        voice* pick_voice(const sf::SoundBuffer& b, sound_priority p)
+        {
+            voice* stopped{nullptr};
+            voice* result{nullptr};
+
+            for(auto& v : _voices)
+            {
+                if(v._sound.getStatus() == sf::Sound::Stopped)
+                {
+                    if(v._sound.getBuffer() == &b) return &v;
+                    if(stopped == nullptr || v._sound.getBuffer() == nullptr)
+                        stopped = &v;
+                    continue;
+                }
+
+                if(stopped != nullptr || v._priority > p) continue;
+
+                if(result == nullptr || v._priority < result->_priority ||
+                    (v._priority == result->_priority &&
+                        v._started < result->_started))
+                    result = &v;
+            }
+
+            return stopped != nullptr ? stopped : result;
+        }
+
+    public:
+        voice_pool(float default_min_interval_seconds = 0.03f)
+            : _default_min_interval{
+                  std::chrono::duration_cast<clock::duration>(
+                      std::chrono::duration<float>{
+                          default_min_interval_seconds})}
+        {
+        }
+
+        /// @brief Replays of `b` closer than `seconds` apart are dropped.
+        void set_min_interval(const sf::SoundBuffer& b, float seconds)
+        {
+            state_of(b)._min_interval =
+                std::chrono::duration_cast<clock::duration>(
+                    std::chrono::duration<float>{seconds});
+        }
+
+        void set_volume(float x) noexcept { _volume = x; }
+
+        /// @brief Returns whether the sound was played.
+        bool play(const sf::SoundBuffer& b,
+            sound_priority p = sound_priority::normal, float pitch = 1.f)
+        {
+            auto now(clock::now());
+            auto& s(state_of(b));
+
+            if(s._last_played != clock::time_point{} &&
+                now - s._last_played < s._min_interval)
+                return false;
+
+            auto v(pick_voice(b, p));
+            if(v == nullptr) return false;
+
+            s._last_played = now;
+
+            v->_sound.stop();
+            if(v->_sound.getBuffer() != &b) v->_sound.setBuffer(b);
+            v->_sound.setPitch(pitch);
+            v->_sound.setVolume(_volume);
+            v->_sound.play();
+            v->_priority = p;
+            v->_started = now;
+            return true;
+        }
+    };
+}
+GGJ16_NAMESPACE_END
@@ -2,4 +2,6 @@
 
 #include "base/config.hpp"
 #include "base/type_aliases.hpp"
+#include "base/rng.hpp"
+#include "base/profiler.hpp"
 #include "base/boilerplate.hpp"
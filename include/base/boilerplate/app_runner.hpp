@@ -22,7 +22,9 @@ GGJ16_NAMESPACE
                 ssvu::SizeT height) noexcept
             {
                 _window.setTitle(title);
-                _window.setTimer<ssvs::TimerStatic>(0.5f, 0.5f);
+                // One update per frame: the app steps its simulation at a
+                // fixed rate itself, see `game_app`.
+                _window.setTimer<ssvs::TimerDynamic>();
                 _window.setSize(width, height);
                 _window.setFullscreen(false);
                 _window.setFPSLimited(true);
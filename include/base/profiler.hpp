@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include <vrm/pp.hpp>
+#include "./config/names.hpp"
+#include "./type_aliases.hpp"
+
+// `GGJ16_PROFILE_SCOPE(name)` times the enclosing scope. It compiles to
+// nothing unless `GGJ16_PROFILE` is defined (see the CMake option of the
+// same name). `name` must be a string literal.
+#if defined(GGJ16_PROFILE)
+#define GGJ16_PROFILE_SCOPE(name) \
+    ::ggj16::profiler::scope VRM_PP_CAT(ggj16_profile_scope_, __LINE__) { name }
+#else
+#define GGJ16_PROFILE_SCOPE(name) \
+    do                            \
+    {                             \
+    } while(false)
+#endif
+
+GGJ16_NAMESPACE
+{
+    namespace profiler
+    {
+        using clock = std::chrono::steady_clock;
+
+        inline std::uint64_t now_ns() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock::now().time_since_epoch())
+                .count();
+        }
+
+        struct zone_record
+        {
+            const char* _name;
+            std::uint64_t _begin;
+            std::uint64_t _end;
+            std::uint32_t _depth;
+        };
+
+        /// @brief Ring of the most recent zones of one thread. Only the
+        /// owning thread writes; any thread can take a snapshot without
+        /// locking, discarding the records overwritten while copying.
+        /// Record fields are relaxed atomics, so that copying a record
+        /// being overwritten is not a data race, just a discarded copy.
+        class thread_ring
+        {
+        public:
+            static constexpr sz_t capacity{1 << 14};
+
+        private:
+            static constexpr sz_t mask{capacity - 1};
+
+            struct slot
+            {
+                std::atomic<const char*> _name;
+                std::atomic<std::uint64_t> _begin;
+                std::atomic<std::uint64_t> _end;
+                std::atomic<std::uint32_t> _depth;
+            };
+
+            std::array<slot, capacity> _slots;
+            std::atomic<std::uint64_t> _written{0};
+            std::uint32_t _depth{0};
+
+        public:
+            auto enter() noexcept { return _depth++; }
+            void leave() noexcept { --_depth; }
+
+            void push(const zone_record& r) noexcept
+            {
+                constexpr auto relaxed(std::memory_order_relaxed);
+
+                auto w(_written.load(relaxed));
+
+                // Pairs with the fence in `snapshot`: a reader that sees
+                // any of these stores also sees `_written` at least `w`.
+                std::atomic_thread_fence(std::memory_order_release);
+
+                auto& s(_slots[w & mask]);
+                s._name.store(r._name, relaxed);
+                s._begin.store(r._begin, relaxed);
+                s._end.store(r._end, relaxed);
+                s._depth.store(r._depth, relaxed);
+
+                _written.store(w + 1, std::memory_order_release);
+            }
+
+            /// @brief Appends the records still in the ring to `out`, oldest
+            /// first.
+            void snapshot(std::vector<zone_record>& out) const
+            {
+                constexpr auto relaxed(std::memory_order_relaxed);
+
+                auto end(_written.load(std::memory_order_acquire));
+                auto begin(end > capacity ? end - capacity : 0);
+                auto first(out.size());
+
+                for(auto i(begin); i < end; ++i)
+                {
+                    const auto& s(_slots[i & mask]);
+                    out.push_back({s._name.load(relaxed),
+                        s._begin.load(relaxed), s._end.load(relaxed),
+                        s._depth.load(relaxed)});
+                }
+
+                // Drop the records the owner overwrote meanwhile,
+                // including the one it may be writing right now.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                auto now(_written.load(relaxed) + 1);
+                auto overwritten(now > begin + capacity
+                                     ? std::min(now - begin - capacity,
+                                           end - begin)
+                                     : 0);
+
+                out.erase(std::begin(out) + first,
+                    std::begin(out) + first + overwritten);
+            }
+        };
+
+        namespace impl
+        {
+            class registry
+            {
+            private:
+                std::mutex _mutex;
+                std::vector<std::unique_ptr<thread_ring>> _rings;
+
+            public:
+                thread_ring& make_ring()
+                {
+                    std::lock_guard<std::mutex> l{_mutex};
+                    _rings.emplace_back(std::make_unique<thread_ring>());
+                    return *_rings.back();
+                }
+
+                template <typename TF>
+                void for_rings(TF&& f)
+                {
+                    std::lock_guard<std::mutex> l{_mutex};
+                    for(const auto& r : _rings) f(*r);
+                }
+            };
+
+            inline auto& registry_instance() noexcept
+            {
+                static registry result;
+                return result;
+            }
+
+            inline auto& local_ring()
+            {
+                // Registered once per thread; the registry owns the ring.
+                thread_local thread_ring& result{
+                    registry_instance().make_ring()};
+
+                return result;
+            }
+        }
+
+        /// @brief Times the enclosing scope. Use `GGJ16_PROFILE_SCOPE`.
+        class scope
+        {
+        private:
+            thread_ring& _ring;
+            const char* _name;
+            std::uint32_t _depth;
+            std::uint64_t _begin;
+
+        public:
+            scope(const char* name) noexcept
+                : _ring(impl::local_ring()), _name{name},
+                  _depth{_ring.enter()}, _begin{now_ns()}
+            {
+            }
+
+            scope(const scope&) = delete;
+            scope& operator=(const scope&) = delete;
+
+            ~scope()
+            {
+                auto end(now_ns());
+                _ring.leave();
+                _ring.push({_name, _begin, end, _depth});
+            }
+        };
+
+        /// @brief Durations of the most recent frames, in milliseconds.
+        class frame_stats
+        {
+        public:
+            static constexpr sz_t capacity{256};
+
+        private:
+            std::array<float, capacity> _frames{};
+            sz_t _count{0};
+            std::uint64_t _last{0};
+
+        public:
+            /// @brief Marks the end of a frame.
+            void mark() noexcept
+            {
+                auto now(now_ns());
+
+                if(_last != 0)
+                    _frames[_count++ % capacity] = (now - _last) * 1e-6f;
+
+                _last = now;
+            }
+
+            auto size() const noexcept { return std::min(_count, capacity); }
+
+            /// @brief Frame durations, oldest first.
+            template <typename TF>
+            void for_frames(TF&& f) const
+            {
+                for(auto i(_count - size()); i < _count; ++i)
+                    f(_frames[i % capacity]);
+            }
+
+            /// @brief `p`-th percentile (in `[0, 1]`) of the recorded frame
+            /// durations.
+            auto percentile(float p) const
+            {
+                if(size() == 0) return 0.f;
+
+                std::vector<float> v;
+                v.reserve(size());
+                for_frames([&v](float x)
+                    {
+                        v.emplace_back(x);
+                    });
+
+                auto n(std::min(v.size() - 1, sz_t(p * v.size())));
+                std::nth_element(std::begin(v), std::begin(v) + n, std::end(v));
+                return v[n];
+            }
+        };
+
+        /// @brief Frame statistics of the main loop.
+        inline auto& frames() noexcept
+        {
+            static frame_stats result;
+            return result;
+        }
+
+        /// @brief Writes the zones of every thread in the Chrome trace event
+        /// format (load it with chrome://tracing or Perfetto).
+        inline void export_chrome_trace(std::ostream& os)
+        {
+            std::vector<std::vector<zone_record>> zones;
+            std::uint64_t origin{std::numeric_limits<std::uint64_t>::max()};
+
+            impl::registry_instance().for_rings([&](const thread_ring& r)
+                {
+                    zones.emplace_back();
+                    r.snapshot(zones.back());
+
+                    for(const auto& z : zones.back())
+                        origin = std::min(origin, z._begin);
+                });
+
+            // Timestamps are in microseconds, relative to the oldest zone.
+            auto us([](std::uint64_t ns)
+                {
+                    return ns / 1000.0;
+                });
+
+            auto flags(os.flags());
+            auto precision(os.precision(3));
+            os.setf(std::ios::fixed, std::ios::floatfield);
+
+            bool first{true};
+            os << "{\"traceEvents\":[\n";
+
+            for(sz_t t(0); t < zones.size(); ++t)
+            {
+                for(const auto& z : zones[t])
+                {
+                    if(!first) os << ",\n";
+                    first = false;
+
+                    os << "{\"name\":\"" << z._name                 // .
+                       << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << t    // .
+                       << ",\"ts\":" << us(z._begin - origin)         // .
+                       << ",\"dur\":" << us(z._end - z._begin) << "}"; // .
+                }
+            }
+
+            os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+            os.flags(flags);
+            os.precision(precision);
+        }
+    }
+}
+GGJ16_NAMESPACE_END
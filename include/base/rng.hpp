@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include "./config/names.hpp"
+
+GGJ16_NAMESPACE
+{
+    namespace impl
+    {
+        constexpr std::uint64_t splitmix64(std::uint64_t x) noexcept
+        {
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+    }
+
+    /// @brief Small, fast xoshiro128** generator. Every instance owns its
+    /// state, so independent battles (or threads) never share it. A
+    /// `(seed, stream)` pair identifies a sequence: streams of the same seed
+    /// are independent, and any sequence can be reproduced from the pair.
+    /// Satisfies `UniformRandomBitGenerator`.
+    class rng_t
+    {
+    public:
+        using result_type = std::uint32_t;
+        using seed_type = std::uint64_t;
+
+    private:
+        result_type _s[4];
+
+        static constexpr result_type rotl(result_type x, int k) noexcept
+        {
+            return (x << k) | (x >> (32 - k));
+        }
+
+    public:
+        rng_t(seed_type seed = 0, seed_type stream = 0) noexcept
+        {
+            auto x(impl::splitmix64(seed) ^ impl::splitmix64(~stream));
+            auto a(impl::splitmix64(x));
+            auto b(impl::splitmix64(a));
+
+            _s[0] = result_type(a);
+            _s[1] = result_type(a >> 32);
+            _s[2] = result_type(b);
+            _s[3] = result_type(b >> 32);
+
+            // The all-zero state is the only invalid one.
+            if((_s[0] | _s[1] | _s[2] | _s[3]) == 0) _s[0] = 1;
+        }
+
+        static constexpr result_type min() noexcept { return 0; }
+        static constexpr result_type max() noexcept
+        {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        result_type operator()() noexcept
+        {
+            const auto result(rotl(_s[1] * 5, 7) * 9);
+            const auto t(_s[1] << 9);
+
+            _s[2] ^= _s[0];
+            _s[3] ^= _s[1];
+            _s[1] ^= _s[2];
+            _s[0] ^= _s[3];
+            _s[2] ^= t;
+            _s[3] = rotl(_s[3], 11);
+
+            return result;
+        }
+
+        /// @brief Uniform float in `[0, 1)`.
+        float next_float() noexcept
+        {
+            return ((*this)() >> 8) * (1.f / 16777216.f);
+        }
+
+        /// @brief Uniform float in `[min, max)`. Replaces `ssvu::getRndR`.
+        float range(float min, float max) noexcept
+        {
+            return min + next_float() * (max - min);
+        }
+
+        /// @brief Uniform index in `[0, n)`.
+        std::uint32_t index(std::uint32_t n) noexcept
+        {
+            return std::uint32_t((std::uint64_t((*this)()) * n) >> 32);
+        }
+    };
+}
+GGJ16_NAMESPACE_END
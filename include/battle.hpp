@@ -6,7 +6,14 @@
 #include "battle/targeted_stat_effect.hpp"
 #include "battle/stat_buff.hpp"
 #include "battle/battle_participant.hpp"
+#include "battle/battle_event.hpp"
 #include "battle/battle.hpp"
+#include "battle/battle_action.hpp"
+#include "battle/ritual_spec.hpp"
+#include "battle/ritual_catalogue.hpp"
+#include "battle/enemy_ai.hpp"
+#include "battle/gauntlet.hpp"
+#include "battle/battle_log.hpp"
 #include "battle/battle_menu.hpp"
 
 #include "battle/temp.hpp"
@@ -9,6 +9,7 @@
 #include "battle/targeted_stat_effect.hpp"
 #include "battle/stat_buff.hpp"
 #include "battle/battle_participant.hpp"
+#include "battle/battle_event.hpp"
 
 GGJ16_NAMESPACE
 {
@@ -21,6 +22,7 @@ GGJ16_NAMESPACE
         battle_participant _player;
         battle_participant _enemy;
         bool _player_plays{true};
+        int _turn{0};
 
     public:
         auto& player() noexcept { return _player; }
@@ -30,28 +32,36 @@ GGJ16_NAMESPACE
         const auto& enemy() const noexcept { return _enemy; }
 
     private:
-        void player_turn()
+        template <typename TDriver>
+        void player_turn(TDriver& d)
         {
-            // Wait for ritual/action selection
-            // Execute minigame
-            // Apply effects on enem
+            advance_turn();
+            d.player_turn(*this);
         }
 
-        void enemy_turn()
+        template <typename TDriver>
+        void enemy_turn(TDriver& d)
         {
-            // Make AI decision
-            // Apply effect on player
+            auto& stun(_enemy.stunned_for());
+            if(stun > 0)
+            {
+                --stun;
+                return;
+            }
+
+            d.enemy_turn(*this);
         }
 
-        void next_turn()
+        template <typename TDriver>
+        void next_turn(TDriver& d)
         {
             if(_player_plays)
             {
-                player_turn();
+                player_turn(d);
             }
             else
             {
-                enemy_turn();
+                enemy_turn(d);
             }
 
             _player_plays = !_player_plays;
@@ -65,132 +75,185 @@ GGJ16_NAMESPACE
         {
         }
 
-        auto player_dead() { return _player.stats().health() < 0; }
-        auto enemy_dead() { return _enemy.stats().health() < 0; }
-        auto must_continue() { return !player_dead() && !enemy_dead(); }
-        auto is_player_turn() { return _player_plays; }
-
-        void execute_battle()
+        auto player_dead() const noexcept
         {
-            while(must_continue())
-            {
-                next_turn();
-            }
-
-            if(player_dead())
-            {
-                // Game over.
-            }
-
-            if(enemy_dead())
+            return _player.stats().health() <= 0;
+        }
+        auto enemy_dead() const noexcept
+        {
+            return _enemy.stats().health() <= 0;
+        }
+        auto must_continue() const noexcept
+        {
+            return !player_dead() && !enemy_dead();
+        }
+        auto is_player_turn() const noexcept { return _player_plays; }
+        const auto& turn() const noexcept { return _turn; }
+
+        /// @brief Starts the next player turn. Called by `execute_battle`,
+        /// or by the battle screen when driving the battle interactively.
+        void advance_turn() noexcept { ++_turn; }
+
+        /// @brief Runs the battle to completion without any presentation.
+        /// `d` must provide `player_turn(battle_t&)` and
+        /// `enemy_turn(battle_t&)`. The battle is stopped after `max_turns`
+        /// player turns to guard against endless heal loops.
+        template <typename TDriver>
+        void execute_battle(TDriver&& d, int max_turns)
+        {
+            while(must_continue() && _turn < max_turns)
             {
+                next_turn(d);
             }
         }
     };
 
-    enum class battle_event_type
+    class battle_context_t
     {
-        player_damaged,
-        enemy_damaged,
-        player_healed,
-        enemy_healed,
-        player_shield_damaged,
-        player_shield_healed,
-        enemy_shield_damaged,
-        enemy_shield_healed,
-        enemy_stunned
-    };
+    private:
+        cplayer_state* _player_state{nullptr};
+        cenemy_state* _enemy_state{nullptr};
+        battle_t _battle;
+        rng_t::seed_type _seed;
+        rng_t _rng;
+        rng_t _fx_rng;
+        battle_event_queue _events;
 
-    namespace impl
-    {
-        struct b_damage_event
+        template <typename TF>
+        void notify(battle_event_type et, TF&& f_fill)
         {
-            stat_value _amount;
-        };
+            battle_event e{et, _battle.turn()};
+            f_fill(e);
+            apply_event(e);
+        }
 
-        struct b_heal_event
+        void notify_damage(battle_event_type et, stat_value x)
         {
-            stat_value _amount;
-        };
+            notify(et, [x](auto& e)
+                {
+                    e.e_damage()._amount = x;
+                });
+        }
 
-        struct b_stun_event
+        void notify_heal(battle_event_type et, stat_value x)
         {
-            int _turns;
-        };
-    }
-
-#define MAKE_ACCESSORS(name, to_ret)         \
-    auto& name() noexcept { return to_ret; } \
-    const auto& name() const noexcept { return to_ret; }
+            notify(et, [x](auto& e)
+                {
+                    e.e_heal()._amount = x;
+                });
+        }
 
-    class battle_event
-    {
-    private:
-        battle_event_type _et;
+        void notify_stun(battle_event_type et, int x)
+        {
+            notify(et, [x](auto& e)
+                {
+                    e.e_stun()._turns = x;
+                });
+        }
 
-        union
+        void notify_mana(battle_event_type et, stat_value x)
         {
-            impl::b_damage_event _e_damage;
-            impl::b_heal_event _e_heal;
-            impl::b_stun_event _e_stun;
-        } _u;
+            notify(et, [x](auto& e)
+                {
+                    e.e_mana()._amount = x;
+                });
+        }
 
-    public:
-        battle_event(battle_event_type et) : _et(et) {}
+        void notify_ritual(battle_event_type et, ritual_id r, bool success)
+        {
+            notify(et, [r, success](auto& e)
+                {
+                    e.e_ritual()._ritual = r;
+                    e.e_ritual()._success = success;
+                });
+        }
 
-        MAKE_ACCESSORS(e_damage, _u._e_damage)
-        MAKE_ACCESSORS(e_heal, _u._e_heal)
-        MAKE_ACCESSORS(e_stun, _u._e_stun)
+        static void damage(character_stats& cs, stat_value x)
+        {
+            auto h(cs.health() - x);
+            ssvu::clampMin(h, 0);
+            cs.set_health(h);
+        }
 
-        const auto& type() const noexcept { return _et; }
-    };
+        static void heal(character_stats& cs, stat_value x)
+        {
+            auto h(cs.health() + x);
+            ssvu::clampMax(h, cs.eff_maxhealth());
+            cs.set_health(h);
+        }
 
-#undef MAKE_ACCESSORS
+        static void damage_shield(character_stats& cs, stat_value x)
+        {
+            auto s(cs.shield() - x);
+            ssvu::clampMin(s, 0);
+            cs.set_shield(s);
+        }
 
-    class battle_context_t
-    {
-    private:
-        cplayer_state& _player_state;
-        cenemy_state& _enemy_state;
-        battle_t _battle;
+        static void heal_shield(character_stats& cs, stat_value x)
+        {
+            auto s(cs.shield() + x);
+            ssvu::clampMax(s, cs.eff_maxshield());
+            cs.set_shield(s);
+        }
 
-        void notify_damage(battle_event_type et, stat_value x)
+        static void restore_mana(character_stats& cs)
         {
-            battle_event e{et};
-            e.e_damage()._amount = x;
-            on_event(e);
+            cs.set_mana(cs.eff_maxmana());
         }
 
-        void notify_heal(battle_event_type et, stat_value x)
+    public:
+        battle_context_t(cplayer_state& player_state, cenemy_state& enemy_state,
+            const battle_t& battle, rng_t::seed_type seed)
+            : _player_state{&player_state}, _enemy_state{&enemy_state},
+              _battle{battle}, _seed{seed}, _rng{seed, 0}, _fx_rng{seed, 1}
         {
-            battle_event e{et};
-            e.e_heal()._amount = x;
-            on_event(e);
         }
 
-        void notify_stun(battle_event_type et, int x)
+        /// @brief Headless context, without any player/enemy presentation
+        /// state. Used by the batch simulator. Events are not recorded.
+        battle_context_t(const battle_t& battle, rng_t::seed_type seed)
+            : _battle{battle}, _seed{seed}, _rng{seed, 0}, _fx_rng{seed, 1}
         {
-            battle_event e{et};
-            e.e_stun()._turns = x;
-            on_event(e);
+            _events.enabled() = false;
         }
 
+        const auto& seed() const noexcept { return _seed; }
 
-    public:
-        ssvu::Delegate<void(battle_event)> on_event;
+        /// @brief Gameplay random stream: everything that can change the
+        /// outcome of the battle draws from here, so that the battle can be
+        /// reproduced from `seed()`.
+        auto& rng() noexcept { return _rng; }
 
-        battle_context_t(cplayer_state& player_state, cenemy_state& enemy_state,
-            const battle_t& battle)
-            : _player_state{player_state}, _enemy_state{enemy_state},
-              _battle{battle}
+        /// @brief Cosmetic random stream (shakes, sound variations). Kept
+        /// separate so that presentation never perturbs `rng()`.
+        auto& fx_rng() noexcept { return _fx_rng; }
+
+        /// @brief Events produced by this battle, to be drained by the
+        /// presentation once per frame.
+        auto& events() noexcept { return _events; }
+        const auto& events() const noexcept { return _events; }
+
+        auto& player_state() noexcept
         {
+            VRM_CORE_ASSERT(_player_state != nullptr);
+            return *_player_state;
+        }
+        const auto& player_state() const noexcept
+        {
+            VRM_CORE_ASSERT(_player_state != nullptr);
+            return *_player_state;
         }
 
-        auto& player_state() noexcept { return _player_state; }
-        const auto& player_state() const noexcept { return _player_state; }
-
-        auto& enemy_state() noexcept { return _enemy_state; }
-        const auto& enemy_state() const noexcept { return _enemy_state; }
+        auto& enemy_state() noexcept
+        {
+            VRM_CORE_ASSERT(_enemy_state != nullptr);
+            return *_enemy_state;
+        }
+        const auto& enemy_state() const noexcept
+        {
+            VRM_CORE_ASSERT(_enemy_state != nullptr);
+            return *_enemy_state;
+        }
 
         auto& battle() noexcept { return _battle; }
         const auto& battle() const noexcept { return _battle; }
@@ -201,104 +264,153 @@ GGJ16_NAMESPACE
         auto& enemy() noexcept { return battle().enemy(); }
         const auto& enemy() const noexcept { return battle().enemy(); }
 
+        /// @brief Damage actually dealt by an attack of strength `x`, after
+        /// shield reduction.
         template <typename T>
-        auto damage_calc(T& stats, stat_value x)
+        auto damage_calc(const T& stats, stat_value x) const
         {
-            auto& h(stats.health());
-            auto& s(stats.shield());
-            auto& ms(stats.maxshield());
-
-            auto sratio(s / ms);
+            auto sratio(stats.eff_shield() / stats.eff_maxshield());
             auto blocked_dmg(x * (sratio * 0.9f));
-            auto dmg(x - blocked_dmg);
+            return x - blocked_dmg;
+        }
 
+        /// @brief Applies the state change described by `e` and records it.
+        /// Every mutation goes through here, so replaying recorded events
+        /// into a fresh context reproduces the battle bit-exactly.
+        void apply_event(const battle_event& e)
+        {
+            using et = battle_event_type;
 
-            h -= dmg;
-            ssvu::clampMin(h, 0);
+            while(_battle.turn() < e.turn()) _battle.advance_turn();
+
+            auto& ps(player().stats());
+            auto& es(enemy().stats());
+
+            switch(e.type())
+            {
+                case et::player_damaged:
+                    damage(ps, e.e_damage()._amount);
+                    break;
+                case et::enemy_damaged:
+                    damage(es, e.e_damage()._amount);
+                    break;
+                case et::player_healed:
+                    heal(ps, e.e_heal()._amount);
+                    break;
+                case et::enemy_healed:
+                    heal(es, e.e_heal()._amount);
+                    break;
+
+                case et::player_shield_damaged:
+                    damage_shield(ps, e.e_damage()._amount);
+                    break;
+                case et::enemy_shield_damaged:
+                    damage_shield(es, e.e_damage()._amount);
+                    break;
+                case et::player_shield_healed:
+                    heal_shield(ps, e.e_heal()._amount);
+                    break;
+                case et::enemy_shield_healed:
+                    heal_shield(es, e.e_heal()._amount);
+                    break;
+
+                case et::enemy_stunned:
+                    enemy().stunned_for() = e.e_stun()._turns;
+                    break;
+
+                case et::player_mana_spent:
+                    ps.set_mana(ps.mana() - e.e_mana()._amount);
+                    break;
+                case et::player_mana_restored:
+                    restore_mana(ps);
+                    break;
+                case et::enemy_mana_restored:
+                    restore_mana(es);
+                    break;
+
+                case et::ritual_cast:
+                case et::ritual_outcome: break;
+            }
 
-            return dmg;
+            _events.push(e);
         }
 
         void damage_player_by(stat_value x)
         {
-            x = damage_calc(player().stats(), x);
-            notify_damage(battle_event_type::player_damaged, x);
+            notify_damage(battle_event_type::player_damaged,
+                damage_calc(player().stats(), x));
         }
 
         void damage_enemy_by(stat_value x)
         {
-            x = damage_calc(enemy().stats(), x);
-            notify_damage(battle_event_type::enemy_damaged, x);
+            notify_damage(battle_event_type::enemy_damaged,
+                damage_calc(enemy().stats(), x));
         }
 
         void heal_player_by(stat_value x)
         {
-            auto& s(player().stats().health());
-            s += x;
-            ssvu::clampMax(s, player().stats().maxhealth());
-
             notify_heal(battle_event_type::player_healed, x);
         }
 
         void heal_enemy_by(stat_value x)
         {
-            auto& s(enemy().stats().health());
-            s += x;
-            ssvu::clampMax(s, enemy().stats().maxhealth());
-
             notify_heal(battle_event_type::enemy_healed, x);
         }
 
         void damage_player_shield_by(stat_value x)
         {
-            auto& s(player().stats().shield());
-            s -= x;
-            ssvu::clampMin(s, 0);
-
             notify_damage(battle_event_type::player_shield_damaged, x);
         }
 
         void damage_enemy_shield_by(stat_value x)
         {
-            auto& s(enemy().stats().shield());
-            s -= x;
-            ssvu::clampMin(s, 0);
-
             notify_damage(battle_event_type::enemy_shield_damaged, x);
         }
 
         void heal_player_shield_by(stat_value x)
         {
-            auto& s(player().stats().shield());
-            s += x;
-            ssvu::clampMax(s, player().stats().maxshield());
-
             notify_heal(battle_event_type::player_shield_healed, x);
         }
 
         void heal_enemy_shield_by(stat_value x)
         {
-            auto& s(enemy().stats().shield());
-            s += x;
-            ssvu::clampMax(s, enemy().stats().maxshield());
-
             notify_heal(battle_event_type::enemy_shield_healed, x);
         }
 
         void stun_enemy_for(int x)
         {
-            enemy().stunned_for() = x;
             notify_stun(battle_event_type::enemy_stunned, x);
         }
 
+        void spend_player_mana(stat_value x)
+        {
+            notify_mana(battle_event_type::player_mana_spent, x);
+        }
+
         void restore_player_mana()
         {
-            player().stats().mana() = player().stats().maxmana();
+            const auto& s(player().stats());
+            notify_mana(battle_event_type::player_mana_restored,
+                s.eff_maxmana() - s.mana());
         }
 
         void restore_enemy_mana()
         {
-            enemy().stats().mana() = enemy().stats().maxmana();
+            const auto& s(enemy().stats());
+            notify_mana(battle_event_type::enemy_mana_restored,
+                s.eff_maxmana() - s.mana());
+        }
+
+        /// @brief Records that the player started casting ritual `r`.
+        void cast_ritual(ritual_id r)
+        {
+            notify_ritual(battle_event_type::ritual_cast, r, false);
+        }
+
+        /// @brief Records the outcome of the minigame of ritual `r`.
+        void ritual_outcome(ritual_id r, bool success)
+        {
+            notify_ritual(battle_event_type::ritual_outcome, r, success);
         }
     };
 }
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "base.hpp"
+#include "game.hpp"
+
+#include "battle/stat.hpp"
+#include "battle/battle.hpp"
+
+GGJ16_NAMESPACE
+{
+    enum class battle_op_type
+    {
+        none,
+        damage_player,
+        damage_enemy,
+        heal_player,
+        heal_enemy,
+        damage_player_shield,
+        damage_enemy_shield,
+        heal_player_shield,
+        heal_enemy_shield,
+        restore_player_mana
+    };
+
+    constexpr sz_t battle_op_type_count{10};
+
+    /// @brief Names used by data files, indexed by `battle_op_type`.
+    constexpr std::array<const char*, battle_op_type_count>
+        battle_op_type_names{{"none", "damage_player", "damage_enemy",
+            "heal_player", "heal_enemy", "damage_player_shield",
+            "damage_enemy_shield", "heal_player_shield", "heal_enemy_shield",
+            "restore_player_mana"}};
+
+    /// @brief Single stat mutation performed through a `battle_context_t`.
+    struct battle_op
+    {
+        battle_op_type _type;
+        stat_value _amount;
+    };
+
+    constexpr sz_t battle_action_op_count{2};
+
+    /// @brief Fixed-size sequence of operations, executed in order. Used
+    /// both by ritual effects and by enemy AI decisions.
+    struct battle_action
+    {
+        std::array<battle_op, battle_action_op_count> _ops;
+    };
+
+    inline void apply_battle_op(battle_context_t& c, const battle_op& op)
+    {
+        switch(op._type)
+        {
+            case battle_op_type::none: break;
+            case battle_op_type::damage_player:
+                c.damage_player_by(op._amount);
+                break;
+            case battle_op_type::damage_enemy:
+                c.damage_enemy_by(op._amount);
+                break;
+            case battle_op_type::heal_player:
+                c.heal_player_by(op._amount);
+                break;
+            case battle_op_type::heal_enemy:
+                c.heal_enemy_by(op._amount);
+                break;
+            case battle_op_type::damage_player_shield:
+                c.damage_player_shield_by(op._amount);
+                break;
+            case battle_op_type::damage_enemy_shield:
+                c.damage_enemy_shield_by(op._amount);
+                break;
+            case battle_op_type::heal_player_shield:
+                c.heal_player_shield_by(op._amount);
+                break;
+            case battle_op_type::heal_enemy_shield:
+                c.heal_enemy_shield_by(op._amount);
+                break;
+            case battle_op_type::restore_player_mana:
+                c.restore_player_mana();
+                break;
+        }
+    }
+
+    inline void apply_battle_action(
+        battle_context_t& c, const battle_action& a)
+    {
+        for(const auto& op : a._ops) apply_battle_op(c, op);
+    }
+}
+GGJ16_NAMESPACE_END
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "base.hpp"
+#include "game.hpp"
+
+#include "battle/stat.hpp"
+
+GGJ16_NAMESPACE
+{
+    enum class battle_event_type
+    {
+        player_damaged,
+        enemy_damaged,
+        player_healed,
+        enemy_healed,
+        player_shield_damaged,
+        player_shield_healed,
+        enemy_shield_damaged,
+        enemy_shield_healed,
+        enemy_stunned,
+        player_mana_spent,
+        player_mana_restored,
+        enemy_mana_restored,
+        ritual_cast,
+        ritual_outcome
+    };
+
+    constexpr sz_t battle_event_type_count{14};
+
+    /// @brief Identifies a ritual in logs and events.
+    using ritual_id = std::uint16_t;
+
+    namespace impl
+    {
+        struct b_damage_event
+        {
+            stat_value _amount;
+        };
+
+        struct b_heal_event
+        {
+            stat_value _amount;
+        };
+
+        struct b_stun_event
+        {
+            int _turns;
+        };
+
+        struct b_mana_event
+        {
+            stat_value _amount;
+        };
+
+        struct b_ritual_event
+        {
+            ritual_id _ritual;
+            bool _success;
+        };
+    }
+
+#define MAKE_ACCESSORS(name, to_ret)         \
+    auto& name() noexcept { return to_ret; } \
+    const auto& name() const noexcept { return to_ret; }
+
+    /// @brief Something that happened during the player or enemy turn
+    /// `turn()`. Every change to a battle's state is described by an event,
+    /// so applying the same events reproduces the same state.
+    class battle_event
+    {
+    private:
+        battle_event_type _et;
+        int _turn;
+
+        union
+        {
+            impl::b_damage_event _e_damage;
+            impl::b_heal_event _e_heal;
+            impl::b_stun_event _e_stun;
+            impl::b_mana_event _e_mana;
+            impl::b_ritual_event _e_ritual;
+        } _u;
+
+    public:
+        battle_event() = default;
+        battle_event(battle_event_type et, int turn = 0) : _et(et), _turn(turn)
+        {
+        }
+
+        MAKE_ACCESSORS(e_damage, _u._e_damage)
+        MAKE_ACCESSORS(e_heal, _u._e_heal)
+        MAKE_ACCESSORS(e_stun, _u._e_stun)
+        MAKE_ACCESSORS(e_mana, _u._e_mana)
+        MAKE_ACCESSORS(e_ritual, _u._e_ritual)
+
+        const auto& type() const noexcept { return _et; }
+        const auto& turn() const noexcept { return _turn; }
+    };
+
+#undef MAKE_ACCESSORS
+
+    /// @brief Fixed-capacity ring buffer of `battle_event`s. Producers
+    /// append without allocating; consumers drain in batches. When full, the
+    /// oldest event is overwritten and counted in `dropped()`. A disabled
+    /// queue ignores every `push`.
+    class battle_event_queue
+    {
+    public:
+        static constexpr sz_t capacity{64};
+
+    private:
+        static_assert((capacity & (capacity - 1)) == 0,
+            "capacity must be a power of two");
+
+        static constexpr sz_t mask{capacity - 1};
+
+        std::array<battle_event, capacity> _events;
+
+        // Monotonic read/write positions.
+        sz_t _head{0};
+        sz_t _tail{0};
+
+        sz_t _dropped{0};
+        bool _enabled{true};
+
+    public:
+        auto& enabled() noexcept { return _enabled; }
+        const auto& enabled() const noexcept { return _enabled; }
+
+        const auto& dropped() const noexcept { return _dropped; }
+
+        auto size() const noexcept { return _tail - _head; }
+        auto empty() const noexcept { return _head == _tail; }
+
+        void push(const battle_event& e) noexcept
+        {
+            if(!_enabled) return;
+
+            if(size() == capacity)
+            {
+                ++_head;
+                ++_dropped;
+            }
+
+            _events[_tail++ & mask] = e;
+        }
+
+        /// @brief Calls `f` on every queued event, oldest first, then
+        /// empties the queue. Events pushed by `f` are drained as well:
+        /// `f` gets a copy, as its pushes may overwrite the slot.
+        template <typename TF>
+        void drain(TF&& f)
+        {
+            while(_head != _tail)
+            {
+                const auto e(_events[_head++ & mask]);
+                f(e);
+            }
+        }
+
+        void clear() noexcept { _head = _tail; }
+    };
+}
+GGJ16_NAMESPACE_END
@@ -0,0 +1,628 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "base.hpp"
+#include "game.hpp"
+
+#include "battle/stat.hpp"
+#include "battle/battle_event.hpp"
+#include "battle/battle.hpp"
+
+// Binary battle log format. All integers are LEB128 varints; there are no
+// pointers or alignment requirements, so a log can be read straight from a
+// memory-mapped file.
+//
+//     log    := magic version battle*
+//     battle := tag_begin seed stats stats record* tag_end stats stats
+//     record := event | tag_dropped count
+//     event  := type turn_delta payload
+//     stats  := value[stat_count]
+//
+// `turn_delta` is the turn of the event minus the turn of the previous
+// event of the same battle. Stat values and amounts are stored as
+// `zigzag(x) << 1` when `x` is an integer that round-trips exactly (the
+// common case), or as the tag `1` followed by the four raw bytes of the
+// float otherwise, so decoding is always bit-exact.
+// `tag_dropped` marks `count` events lost before they could be logged (the
+// event queue overflowed): the battle cannot be replayed exactly.
+
+GGJ16_NAMESPACE
+{
+    namespace battle_log
+    {
+        constexpr char magic[]{'G', 'G', 'J', '1', '6', 'L', 'O', 'G'};
+        constexpr sz_t magic_size{sizeof(magic)};
+        constexpr std::uint64_t version{2};
+
+        constexpr std::uint8_t tag_begin{0xF0};
+        constexpr std::uint8_t tag_end{0xF1};
+        constexpr std::uint8_t tag_dropped{0xF2};
+
+        using buffer = std::vector<std::uint8_t>;
+
+        /// @brief Start of a logged battle: enough to rebuild it.
+        struct header
+        {
+            rng_t::seed_type _seed;
+            stat_array _player;
+            stat_array _enemy;
+
+            auto make_battle() const
+            {
+                return battle_t{battle_participant{character_stats{_player}},
+                    battle_participant{character_stats{_enemy}}};
+            }
+        };
+
+        /// @brief Final state of a logged battle, to verify replays.
+        struct footer
+        {
+            stat_array _player;
+            stat_array _enemy;
+        };
+
+        namespace impl
+        {
+            inline auto zigzag(std::int64_t x) noexcept
+            {
+                return (std::uint64_t(x) << 1) ^ std::uint64_t(x >> 63);
+            }
+
+            inline auto unzigzag(std::uint64_t x) noexcept
+            {
+                return std::int64_t(x >> 1) ^ -std::int64_t(x & 1);
+            }
+
+            inline auto float_bits(float x) noexcept
+            {
+                std::uint32_t result;
+                std::memcpy(&result, &x, sizeof(result));
+                return result;
+            }
+
+            inline auto bits_float(std::uint32_t x) noexcept
+            {
+                float result;
+                std::memcpy(&result, &x, sizeof(result));
+                return result;
+            }
+        }
+
+        /// @brief Appends log records to a byte buffer.
+        class encoder
+        {
+        private:
+            buffer& _out;
+            int _prev_turn{0};
+
+            void put_byte(std::uint8_t x) { _out.emplace_back(x); }
+
+            void put_varint(std::uint64_t x)
+            {
+                while(x >= 0x80)
+                {
+                    put_byte(std::uint8_t(x | 0x80));
+                    x >>= 7;
+                }
+
+                put_byte(std::uint8_t(x));
+            }
+
+            void put_value(float x)
+            {
+                constexpr float limit{1 << 24};
+
+                if(x > -limit && x < limit)
+                {
+                    auto i(static_cast<std::int64_t>(x));
+                    auto back(static_cast<float>(i));
+
+                    if(impl::float_bits(back) == impl::float_bits(x))
+                    {
+                        put_varint(impl::zigzag(i) << 1);
+                        return;
+                    }
+                }
+
+                put_varint(1);
+
+                auto bits(impl::float_bits(x));
+                for(int i(0); i < 4; ++i)
+                    put_byte(std::uint8_t(bits >> (8 * i)));
+            }
+
+            void put_stats(const stat_array& a)
+            {
+                for(auto x : a) put_value(x);
+            }
+
+        public:
+            encoder(buffer& out) noexcept : _out(out) {}
+
+            void file_header()
+            {
+                for(auto c : magic) put_byte(std::uint8_t(c));
+                put_varint(version);
+            }
+
+            void begin(const header& h)
+            {
+                _prev_turn = 0;
+
+                put_byte(tag_begin);
+                put_varint(h._seed);
+                put_stats(h._player);
+                put_stats(h._enemy);
+            }
+
+            void event(const battle_event& e)
+            {
+                using et = battle_event_type;
+
+                VRM_CORE_ASSERT_OP(e.turn(), >=, _prev_turn);
+
+                put_byte(std::uint8_t(vrmc::from_enum(e.type())));
+                put_varint(std::uint64_t(e.turn() - _prev_turn));
+                _prev_turn = e.turn();
+
+                switch(e.type())
+                {
+                    case et::player_damaged:
+                    case et::enemy_damaged:
+                    case et::player_shield_damaged:
+                    case et::enemy_shield_damaged:
+                        put_value(e.e_damage()._amount);
+                        break;
+
+                    case et::player_healed:
+                    case et::enemy_healed:
+                    case et::player_shield_healed:
+                    case et::enemy_shield_healed:
+                        put_value(e.e_heal()._amount);
+                        break;
+
+                    case et::enemy_stunned:
+                        put_varint(impl::zigzag(e.e_stun()._turns));
+                        break;
+
+                    case et::player_mana_spent:
+                    case et::player_mana_restored:
+                    case et::enemy_mana_restored:
+                        put_value(e.e_mana()._amount);
+                        break;
+
+                    case et::ritual_cast:
+                    case et::ritual_outcome:
+                        put_varint(e.e_ritual()._ritual);
+                        put_byte(e.e_ritual()._success);
+                        break;
+                }
+            }
+
+            void dropped(std::uint64_t count)
+            {
+                put_byte(tag_dropped);
+                put_varint(count);
+            }
+
+            void end(const footer& f)
+            {
+                put_byte(tag_end);
+                put_stats(f._player);
+                put_stats(f._enemy);
+            }
+        };
+
+        /// @brief Reads a log from a byte range, which must outlive the
+        /// reader. Malformed input makes the reader invalid instead of
+        /// reading out of bounds.
+        class reader
+        {
+        private:
+            const std::uint8_t* _itr;
+            const std::uint8_t* _end;
+            bool _valid{true};
+            int _prev_turn{0};
+            std::uint64_t _dropped{0};
+
+            bool fail() noexcept
+            {
+                _valid = false;
+                _itr = _end;
+                return false;
+            }
+
+            bool get_byte(std::uint8_t& x) noexcept
+            {
+                if(_itr == _end) return fail();
+
+                x = *_itr++;
+                return true;
+            }
+
+            bool get_varint(std::uint64_t& x) noexcept
+            {
+                x = 0;
+
+                for(int shift(0); shift < 64; shift += 7)
+                {
+                    std::uint8_t b;
+                    if(!get_byte(b)) return false;
+
+                    x |= std::uint64_t(b & 0x7F) << shift;
+                    if((b & 0x80) == 0) return true;
+                }
+
+                return fail();
+            }
+
+            bool get_value(float& x) noexcept
+            {
+                std::uint64_t v;
+                if(!get_varint(v)) return false;
+
+                if(v != 1)
+                {
+                    x = static_cast<float>(impl::unzigzag(v >> 1));
+                    return true;
+                }
+
+                std::uint32_t bits{0};
+                for(int i(0); i < 4; ++i)
+                {
+                    std::uint8_t b;
+                    if(!get_byte(b)) return false;
+
+                    bits |= std::uint32_t(b) << (8 * i);
+                }
+
+                x = impl::bits_float(bits);
+                return true;
+            }
+
+            bool get_stats(stat_array& a) noexcept
+            {
+                for(auto& x : a)
+                    if(!get_value(x)) return false;
+
+                return true;
+            }
+
+            bool get_event(std::uint8_t type, battle_event& e) noexcept
+            {
+                using et = battle_event_type;
+
+                if(type >= battle_event_type_count) return fail();
+
+                std::uint64_t dt;
+                if(!get_varint(dt)) return false;
+
+                _prev_turn += static_cast<int>(dt);
+                e = battle_event{et(type), _prev_turn};
+
+                std::uint64_t v;
+
+                switch(e.type())
+                {
+                    case et::player_damaged:
+                    case et::enemy_damaged:
+                    case et::player_shield_damaged:
+                    case et::enemy_shield_damaged:
+                        return get_value(e.e_damage()._amount);
+
+                    case et::player_healed:
+                    case et::enemy_healed:
+                    case et::player_shield_healed:
+                    case et::enemy_shield_healed:
+                        return get_value(e.e_heal()._amount);
+
+                    case et::enemy_stunned:
+                        if(!get_varint(v)) return false;
+                        e.e_stun()._turns = int(impl::unzigzag(v));
+                        return true;
+
+                    case et::player_mana_spent:
+                    case et::player_mana_restored:
+                    case et::enemy_mana_restored:
+                        return get_value(e.e_mana()._amount);
+
+                    case et::ritual_cast:
+                    case et::ritual_outcome:
+                    {
+                        std::uint8_t success;
+                        if(!get_varint(v) || !get_byte(success)) return false;
+
+                        e.e_ritual()._ritual = ritual_id(v);
+                        e.e_ritual()._success = success != 0;
+                        return true;
+                    }
+                }
+
+                return fail();
+            }
+
+        public:
+            reader(const std::uint8_t* data, sz_t size) noexcept
+                : _itr{data}, _end{data + size}
+            {
+                if(size < magic_size ||
+                    std::memcmp(data, magic, magic_size) != 0)
+                {
+                    fail();
+                    return;
+                }
+
+                _itr += magic_size;
+
+                // Version 1 logs are the same, without `tag_dropped`.
+                std::uint64_t v;
+                if(get_varint(v) && (v == 0 || v > version)) fail();
+            }
+
+            reader(const buffer& b) noexcept : reader(b.data(), b.size()) {}
+
+            const auto& valid() const noexcept { return _valid; }
+            auto done() const noexcept { return _itr == _end; }
+
+            /// @brief Events of the current battle that were lost before
+            /// being logged.
+            const auto& dropped() const noexcept { return _dropped; }
+
+            /// @brief Reads the header of the next battle. Returns `false`
+            /// at the end of the log.
+            bool next_battle(header& h) noexcept
+            {
+                if(done()) return false;
+
+                std::uint8_t tag;
+                if(!get_byte(tag) || tag != tag_begin) return fail();
+
+                _prev_turn = 0;
+                _dropped = 0;
+                return get_varint(h._seed) && get_stats(h._player) &&
+                       get_stats(h._enemy);
+            }
+
+            /// @brief Calls `f` on every event of the current battle, then
+            /// reads its footer.
+            template <typename TF>
+            bool read_events(TF&& f, footer& ft)
+            {
+                std::uint8_t tag;
+                battle_event e;
+
+                while(get_byte(tag))
+                {
+                    if(tag == tag_end)
+                        return get_stats(ft._player) && get_stats(ft._enemy);
+
+                    if(tag == tag_dropped)
+                    {
+                        std::uint64_t n;
+                        if(!get_varint(n)) return false;
+
+                        _dropped += n;
+                        continue;
+                    }
+
+                    if(!get_event(tag, e)) return false;
+                    f(e);
+                }
+
+                return false;
+            }
+        };
+
+        /// @brief Replays the next battle of `r` into a fresh headless
+        /// context, calling `f(ctx, event)` after every event is applied.
+        /// Returns `false` at the end of the log or on malformed input;
+        /// otherwise `matches` tells whether the final state is bit-exactly
+        /// the logged one.
+        template <typename TF>
+        bool replay_next(reader& r, TF&& f, bool& matches)
+        {
+            header h;
+            if(!r.next_battle(h)) return false;
+
+            battle_context_t ctx{h.make_battle(), h._seed};
+            footer ft;
+
+            auto ok(r.read_events(
+                [&](const battle_event& e)
+                {
+                    ctx.apply_event(e);
+                    f(ctx, e);
+                },
+                ft));
+
+            if(!ok) return false;
+
+            auto same([](const stat_array& a, const stat_array& b)
+                {
+                    return std::memcmp(a.data(), b.data(), sizeof(a)) == 0;
+                });
+
+            matches = same(ctx.player().stats().array(), ft._player) &&
+                      same(ctx.enemy().stats().array(), ft._enemy);
+
+            return true;
+        }
+
+        /// @brief Streams a log to a file. Records are encoded on the
+        /// calling thread into a local buffer, which is handed to a
+        /// background thread for writing: the caller only ever takes a
+        /// mutex to swap buffers, and never waits on file I/O. If the file
+        /// cannot be opened, nothing is logged.
+        class writer
+        {
+        private:
+            static constexpr sz_t flush_size{4096};
+
+            std::ofstream _os;
+            bool _open;
+            buffer _front;
+            buffer _back;
+            encoder _encoder{_front};
+            bool _in_battle{false};
+
+            std::mutex _mutex;
+            std::condition_variable _cv;
+            bool _done{false};
+            std::thread _thread;
+
+            void run()
+            {
+                buffer chunk;
+
+                while(true)
+                {
+                    {
+                        std::unique_lock<std::mutex> l{_mutex};
+                        _cv.wait(l, [this]
+                            {
+                                return _done || !_back.empty();
+                            });
+
+                        if(_back.empty()) return;
+                        std::swap(chunk, _back);
+                    }
+
+                    _os.write(reinterpret_cast<const char*>(chunk.data()),
+                        chunk.size());
+                    chunk.clear();
+                }
+            }
+
+            void maybe_flush()
+            {
+                if(_front.size() >= flush_size) flush();
+            }
+
+        public:
+            writer(const std::string& path)
+                : _os{path, std::ios::binary | std::ios::trunc},
+                  _open{bool(_os)}
+            {
+                if(!_open)
+                {
+                    std::cerr << "Failed to open battle log: " << path
+                              << "\n";
+                    return;
+                }
+
+                _encoder.file_header();
+                _thread = std::thread{[this]
+                    {
+                        run();
+                    }};
+            }
+
+            writer(const writer&) = delete;
+            writer& operator=(const writer&) = delete;
+
+            ~writer()
+            {
+                if(!_open) return;
+
+                flush();
+
+                {
+                    std::lock_guard<std::mutex> l{_mutex};
+                    _done = true;
+                }
+
+                _cv.notify_one();
+                _thread.join();
+            }
+
+            const auto& in_battle() const noexcept { return _in_battle; }
+
+            /// @brief Starts logging the battle of `ctx`, which must be in
+            /// its initial state.
+            void begin(const battle_context_t& ctx)
+            {
+                VRM_CORE_ASSERT(!_in_battle);
+                _in_battle = true;
+
+                if(!_open) return;
+                _encoder.begin({ctx.seed(), ctx.player().stats().array(),
+                    ctx.enemy().stats().array()});
+            }
+
+            void event(const battle_event& e)
+            {
+                VRM_CORE_ASSERT(_in_battle);
+                if(!_open) return;
+
+                _encoder.event(e);
+                maybe_flush();
+            }
+
+            /// @brief Records that `count` events of the current battle were
+            /// lost before they could be logged.
+            void dropped(sz_t count)
+            {
+                VRM_CORE_ASSERT(_in_battle);
+                if(!_open) return;
+
+                _encoder.dropped(count);
+                maybe_flush();
+            }
+
+            void end(const battle_context_t& ctx)
+            {
+                VRM_CORE_ASSERT(_in_battle);
+                _in_battle = false;
+
+                if(!_open) return;
+                _encoder.end({ctx.player().stats().array(),
+                    ctx.enemy().stats().array()});
+                flush();
+            }
+
+            /// @brief Hands the encoded records to the background thread.
+            void flush()
+            {
+                if(_front.empty()) return;
+
+                {
+                    std::lock_guard<std::mutex> l{_mutex};
+                    _back.insert(std::end(_back), std::begin(_front),
+                        std::end(_front));
+                }
+
+                _front.clear();
+                _cv.notify_one();
+            }
+        };
+
+        /// @brief `<prefix>-<local date>-<local time>.ggjlog`, so that every
+        /// run writes its own log.
+        inline auto timestamped_path(const std::string& prefix)
+        {
+            auto t(std::time(nullptr));
+            char stamp[32];
+            std::strftime(
+                stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&t));
+
+            return prefix + "-" + stamp + ".ggjlog";
+        }
+
+        /// @brief Reads a whole log file into memory.
+        inline auto load(const std::string& path)
+        {
+            std::ifstream is{path, std::ios::binary};
+            return buffer{std::istreambuf_iterator<char>{is},
+                std::istreambuf_iterator<char>{}};
+        }
+    }
+}
+GGJ16_NAMESPACE_END
@@ -120,7 +120,7 @@ GGJ16_NAMESPACE
     {
     private:
         sf::RectangleShape _shape;
-        ssvs::BitmapTextRich _tr{*assets().fontObStroked};
+        glyph_run _label{*assets().fontObStroked, -3};
         battle_screen& _bs;
         vec2f _pos;
         const battle_menu_choice& _bmc;
@@ -146,9 +146,9 @@ GGJ16_NAMESPACE
             battle_screen& bs, const vec2f& pos, const battle_menu_choice& bmc)
             : _bs{bs}, _pos(pos), _bmc(bmc)
         {
-            _tr.setAlign(ssvs::TextAlign::Center);
-            _tr.eff<BTR::Tracking>(-3).in(_bmc.label()).mk("");
-            _tr.setScale(vec2f(3.f, 3.f));
+            _label.set_string(_bmc.label());
+            _label.setScale(vec2f(3.f, 3.f));
+            _label.center_origin();
 
             vec2f shape_sz(btn_w, btn_h);
             _shape.setSize(shape_sz);
@@ -157,10 +157,10 @@ GGJ16_NAMESPACE
 
         void update(game_app& app, battle_menu& bm, ft dt);
 
-        void draw(sf::RenderTarget& rt)
+        void add_to(batch_renderer& b) const
         {
-            rt.draw(_shape);
-            rt.draw(_tr);
+            b.add(_shape);
+            _label.add_to(b);
         }
     };
 
@@ -171,6 +171,8 @@ GGJ16_NAMESPACE
 
         void rebuild_from(battle_screen& b, const battle_menu_screen& bs)
         {
+            GGJ16_PROFILE_SCOPE("battle_menu_gfx_state::rebuild_from");
+
             _buttons.clear();
 
             auto menu_h(200);
@@ -223,9 +225,10 @@ GGJ16_NAMESPACE
             }
         }
 
-        void draw(sf::RenderTarget& rt)
+        void draw(game_app& app)
         {
-            for(auto& b : _buttons) b.draw(rt);
+            for(const auto& b : _buttons) b.add_to(app.batch());
+            app.flush_batch();
         }
     };
 }
@@ -4,26 +4,49 @@
 #include "game.hpp"
 
 #include "battle/stat.hpp"
+#include "battle/stat_buff.hpp"
 
-#define GGJ16_DEFINE_STAT_ACCESSOR(name, type)  \
-    auto& name() noexcept { return get(type); } \
-    const auto& name() const noexcept { return get(type); }
+#define GGJ16_DEFINE_STAT_ACCESSOR(name, type)              \
+    const auto& name() const noexcept { return get(type); } \
+    void set_##name(stat_value x) noexcept { set(type, x); }
+
+#define GGJ16_DEFINE_EFF_STAT_ACCESSOR(name, type) \
+    const auto& name() const noexcept { return get_stat(type, effective()); }
 
 GGJ16_NAMESPACE
 {
+    /// @brief Base stats plus a stack of active buffs. The effective stats
+    /// (base stats with all the buffs applied) are cached, and recomputed
+    /// only after the base stats or the buff stack change: base stats are
+    /// only written through `set_*`, which invalidates the cache.
     class character_stats
     {
     private:
         stat_array _stat_array;
+        std::vector<stat_buff> _buffs;
+
+        // All of `_buffs`, fused.
+        stat_buff _fused_buff;
 
-        auto& get(stat_type type) noexcept
+        mutable stat_array _effective;
+        mutable bool _dirty{true};
+
+        const auto& get(stat_type type) const noexcept
         {
             return get_stat(type, _stat_array);
         }
 
-        const auto& get(stat_type type) const noexcept
+        void set(stat_type type, stat_value x) noexcept
         {
-            return get_stat(type, _stat_array);
+            get_stat(type, _stat_array) = x;
+            _dirty = true;
+        }
+
+        void rebuild_fused_buff() noexcept
+        {
+            _fused_buff = stat_buff{};
+            for(const auto& b : _buffs) _fused_buff.add(b);
+            _dirty = true;
         }
 
     public:
@@ -31,6 +54,47 @@ GGJ16_NAMESPACE
         character_stats(const character_stats&) = default;
         character_stats& operator=(const character_stats&) = default;
 
+        explicit character_stats(const stat_array& array) noexcept
+            : _stat_array(array), _effective(array), _dirty{false}
+        {
+        }
+
+        const auto& array() const noexcept { return _stat_array; }
+
+        /// @brief Base stats with all the active buffs applied.
+        const auto& effective() const noexcept
+        {
+            if(_dirty)
+            {
+                _effective = _fused_buff.compute(_stat_array);
+                _dirty = false;
+            }
+
+            return _effective;
+        }
+
+        const auto& buffs() const noexcept { return _buffs; }
+
+        void push_buff(const stat_buff& b)
+        {
+            _buffs.emplace_back(b);
+            _fused_buff.add(b);
+            _dirty = true;
+        }
+
+        void pop_buff()
+        {
+            VRM_CORE_ASSERT_OP(_buffs.size(), >, 0);
+            _buffs.pop_back();
+            rebuild_fused_buff();
+        }
+
+        void clear_buffs() noexcept
+        {
+            _buffs.clear();
+            rebuild_fused_buff();
+        }
+
         GGJ16_DEFINE_STAT_ACCESSOR(health, stat_type::health)
         GGJ16_DEFINE_STAT_ACCESSOR(shield, stat_type::shield)
         GGJ16_DEFINE_STAT_ACCESSOR(power, stat_type::power)
@@ -38,6 +102,14 @@ GGJ16_NAMESPACE
         GGJ16_DEFINE_STAT_ACCESSOR(maxshield, stat_type::maxshield)
         GGJ16_DEFINE_STAT_ACCESSOR(mana, stat_type::mana)
         GGJ16_DEFINE_STAT_ACCESSOR(maxmana, stat_type::maxmana)
+
+        GGJ16_DEFINE_EFF_STAT_ACCESSOR(eff_health, stat_type::health)
+        GGJ16_DEFINE_EFF_STAT_ACCESSOR(eff_shield, stat_type::shield)
+        GGJ16_DEFINE_EFF_STAT_ACCESSOR(eff_power, stat_type::power)
+        GGJ16_DEFINE_EFF_STAT_ACCESSOR(eff_maxhealth, stat_type::maxhealth)
+        GGJ16_DEFINE_EFF_STAT_ACCESSOR(eff_maxshield, stat_type::maxshield)
+        GGJ16_DEFINE_EFF_STAT_ACCESSOR(eff_mana, stat_type::mana)
+        GGJ16_DEFINE_EFF_STAT_ACCESSOR(eff_maxmana, stat_type::maxmana)
     };
 }
 GGJ16_NAMESPACE_END
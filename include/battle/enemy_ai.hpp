@@ -0,0 +1,125 @@
+#pragma once
+
+#include "base.hpp"
+#include "game.hpp"
+
+#include "battle/character_stats.hpp"
+#include "battle/battle_action.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief What an enemy decided to do this turn. The decision is pure
+    /// (it only reads the player and enemy stats): `_action` still has to be
+    /// applied to the battle.
+    struct enemy_decision
+    {
+        const char* _msg;
+        battle_action _action;
+    };
+
+    using enemy_ai_fn = enemy_decision (*)(
+        const character_stats& ps, const character_stats& es);
+
+    namespace enemy_ai
+    {
+        namespace impl
+        {
+            constexpr battle_action mk_action(battle_op_type t0, stat_value a0,
+                battle_op_type t1, stat_value a1) noexcept
+            {
+                return {{{{t0, a0}, {t1, a1}}}};
+            }
+
+            constexpr const char* msg_heal{
+                "The demon attempts to heal himself!"};
+            constexpr const char* msg_restore_shield{
+                "The demon attempts to restore his shield!"};
+            constexpr const char* msg_armor_piercing{
+                "The demon performs\nan armor-piercing attack!"};
+            constexpr const char* msg_pounce{
+                "The demon pounces at the player."};
+
+            constexpr enemy_decision heal(stat_value hp, stat_value sdmg)
+            {
+                return {msg_heal,
+                    mk_action(battle_op_type::heal_enemy, hp,
+                            battle_op_type::damage_enemy_shield, sdmg)};
+            }
+
+            constexpr enemy_decision restore_shield(
+                stat_value shp, stat_value dmg)
+            {
+                return {msg_restore_shield,
+                    mk_action(battle_op_type::heal_enemy_shield, shp,
+                            battle_op_type::damage_enemy, dmg)};
+            }
+
+            constexpr enemy_decision armor_piercing(
+                stat_value sdmg, stat_value dmg)
+            {
+                return {msg_armor_piercing,
+                    mk_action(battle_op_type::damage_player_shield, sdmg,
+                            battle_op_type::damage_player, dmg)};
+            }
+
+            constexpr enemy_decision pounce(stat_value dmg, stat_value sdmg)
+            {
+                return {msg_pounce,
+                    mk_action(battle_op_type::damage_player, dmg,
+                            battle_op_type::damage_player_shield, sdmg)};
+            }
+        }
+
+        inline enemy_decision first(
+            const character_stats&, const character_stats& es)
+        {
+            if(es.eff_health() <= es.eff_maxhealth() * 0.2)
+                return impl::heal(10, 5);
+
+            return impl::pounce(30, 3);
+        }
+
+        inline enemy_decision second(
+            const character_stats& ps, const character_stats& es)
+        {
+            if(es.eff_health() <= es.eff_maxhealth() * 0.3)
+                return impl::heal(12, 4);
+
+            if(ps.eff_shield() >= ps.eff_maxshield() * 0.8)
+                return impl::armor_piercing(20, 5);
+
+            return impl::pounce(35, 4);
+        }
+
+        inline enemy_decision third(
+            const character_stats& ps, const character_stats& es)
+        {
+            if(es.eff_health() <= es.eff_maxhealth() * 0.3)
+                return impl::heal(14, 3);
+
+            if(es.eff_shield() <= es.eff_maxshield() * 0.2)
+                return impl::restore_shield(10, 5);
+
+            if(ps.eff_shield() >= ps.eff_maxshield() * 0.7)
+                return impl::armor_piercing(25, 7);
+
+            return impl::pounce(40, 5);
+        }
+
+        inline enemy_decision fourth(
+            const character_stats& ps, const character_stats& es)
+        {
+            if(es.eff_health() <= es.eff_maxhealth() * 0.3)
+                return impl::heal(18, 4);
+
+            if(es.eff_shield() <= es.eff_maxshield() * 0.3)
+                return impl::restore_shield(20, 5);
+
+            if(ps.eff_shield() >= ps.eff_maxshield() * 0.6)
+                return impl::armor_piercing(30, 15);
+
+            return impl::pounce(50, 7);
+        }
+    }
+}
+GGJ16_NAMESPACE_END
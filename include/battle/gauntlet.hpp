@@ -0,0 +1,71 @@
+#pragma once
+
+#include "base.hpp"
+#include "game.hpp"
+
+#include "battle/stat.hpp"
+#include "battle/character_stats.hpp"
+#include "battle/battle_participant.hpp"
+#include "battle/battle.hpp"
+#include "battle/enemy_ai.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief Tuning data for the four-demon gauntlet. Shared by the game
+    /// and the headless simulator so that balance sweeps match the game.
+    namespace gauntlet
+    {
+        constexpr sz_t demon_count{4};
+
+        inline auto make_stats(stat_value health, stat_value shield,
+            stat_value mana, stat_value power)
+        {
+            character_stats result;
+            result.set_health(health);
+            result.set_maxhealth(health);
+            result.set_shield(shield);
+            result.set_maxshield(shield);
+            result.set_mana(mana);
+            result.set_maxmana(mana);
+            result.set_power(power);
+            return result;
+        }
+
+        inline auto player_stats() { return make_stats(100, 50, 100, 100); }
+
+        inline auto demon_stats(sz_t idx)
+        {
+            VRM_CORE_ASSERT_OP(idx, <, demon_count);
+
+            constexpr std::array<std::array<stat_value, 4>, demon_count>
+                table{{
+                    {{50, 30, 100, 10}},  // .
+                    {{60, 35, 200, 20}},  // .
+                    {{70, 50, 300, 30}},  // .
+                    {{100, 60, 400, 40}}, // .
+                }};
+
+            const auto& r(table[idx]);
+            return make_stats(r[0], r[1], r[2], r[3]);
+        }
+
+        inline enemy_ai_fn demon_ai(sz_t idx)
+        {
+            VRM_CORE_ASSERT_OP(idx, <, demon_count);
+
+            constexpr std::array<enemy_ai_fn, demon_count> table{{
+                &enemy_ai::first, &enemy_ai::second, &enemy_ai::third,
+                &enemy_ai::fourth,
+            }};
+
+            return table[idx];
+        }
+
+        inline auto make_battle(sz_t idx)
+        {
+            return battle_t{battle_participant{player_stats()},
+                battle_participant{demon_stats(idx)}};
+        }
+    }
+}
+GGJ16_NAMESPACE_END
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <array>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "base.hpp"
+#include "game.hpp"
+
+#include "battle/stat.hpp"
+#include "battle/battle_action.hpp"
+#include "battle/ritual_spec.hpp"
+
+// Ritual catalogue, `data/rituals.json`. Parsed once at startup into
+// immutable tables: casting a ritual only copies them into a minigame.
+//
+//     {"rituals": [ritual*]}
+//
+//     ritual := {
+//         "id": int,              built-in spec id, or a new one
+//         "label": string,        only for new ids
+//         "mana": float,          only for new ids
+//         "ops": [[op, float]*],  only for new ids
+//         "menu": "attack" | "utility" | "mana",
+//         "desc": string,
+//         "type": "complete" | "resist",
+//         "time": float,          seconds
+//         "sound": string,        optional, played on success
+//         "minigame": "symbol" | "aura" | "drag",
+//         "points": [[x, y, radius]*],  symbol and aura only
+//         "targets": [[x, y]*],         drag only
+//         "draggables": [[x, y]*],      drag only
+//         "scatter": [count, margin]    drag only, optional
+//     }
+//
+// The gameplay fields of built-in ids come from `ritual_specs`, which the
+// simulator shares, and are ignored here. Sounds must be known to the
+// loading code, which checks them while parsing.
+// Positions are relative to the screen center. Scattered draggables are
+// placed at random when the minigame starts, away from the screen edges.
+
+GGJ16_NAMESPACE
+{
+    enum class ritual_type
+    {
+        resist,
+        complete
+    };
+
+    enum class ritual_minigame_kind
+    {
+        symbol,
+        aura,
+        drag
+    };
+
+    enum class ritual_menu
+    {
+        attack,
+        utility,
+        mana
+    };
+
+    /// @brief Names used by the catalogue, indexed by enum value.
+    constexpr std::array<const char*, 2> ritual_type_names{
+        {"resist", "complete"}};
+
+    constexpr std::array<const char*, 3> ritual_minigame_kind_names{
+        {"symbol", "aura", "drag"}};
+
+    constexpr std::array<const char*, 3> ritual_menu_names{
+        {"attack", "utility", "mana"}};
+
+    struct ritual_point
+    {
+        vec2f _offset;
+        float _radius;
+    };
+
+    struct ritual_scatter
+    {
+        sz_t _count{0};
+        float _margin{0.f};
+    };
+
+    struct ritual_def
+    {
+        ritual_id _id;
+        std::string _label;
+        stat_value _req_mana;
+        battle_action _action;
+
+        ritual_menu _menu;
+        std::string _desc;
+        ritual_type _type;
+        float _time;
+        std::string _sound;
+
+        ritual_minigame_kind _minigame;
+        std::vector<ritual_point> _points;
+        std::vector<vec2f> _targets;
+        std::vector<vec2f> _draggables;
+        ritual_scatter _scatter;
+    };
+
+    class ritual_catalogue
+    {
+    private:
+        std::vector<ritual_def> _defs;
+
+        template <typename T, sz_t TN>
+        static bool parse_name(const std::array<const char*, TN>& names,
+            const ssvj::Val& v, T& out)
+        {
+            auto name(v.as<std::string>());
+
+            for(sz_t i(0); i < TN; ++i)
+            {
+                if(name != names[i]) continue;
+
+                out = T(i);
+                return true;
+            }
+
+            std::cerr << "rituals: unknown name \"" << name << "\"\n";
+            return false;
+        }
+
+        static bool parse_gameplay(const ssvj::Val& v, ritual_def& d)
+        {
+            // Built-in specs are shared with the simulator: keep them.
+            auto spec(ritual_specs::find(d._id));
+            if(spec != nullptr)
+            {
+                d._label = spec->_label;
+                d._req_mana = spec->_req_mana;
+                d._action = spec->_action;
+                return true;
+            }
+
+            d._label = v["label"].as<std::string>();
+            d._req_mana = v["mana"].as<stat_value>();
+            d._action = battle_action{};
+
+            sz_t i{0};
+            for(const auto& op : v["ops"].forArr())
+            {
+                if(i == battle_action_op_count)
+                {
+                    std::cerr << "rituals: \"" << d._label
+                              << "\" has too many ops\n";
+                    return false;
+                }
+
+                auto& o(d._action._ops[i++]);
+                o._amount = op[1].as<stat_value>();
+
+                if(!parse_name(battle_op_type_names, op[0], o._type))
+                    return false;
+            }
+
+            return true;
+        }
+
+        template <typename TF>
+        static bool parse(const ssvj::Val& v, TF& sound_exists, ritual_def& d)
+        {
+            d._id = v["id"].as<int>();
+            if(!parse_gameplay(v, d)) return false;
+
+            if(!parse_name(ritual_menu_names, v["menu"], d._menu) ||
+                !parse_name(ritual_type_names, v["type"], d._type) ||
+                !parse_name(
+                    ritual_minigame_kind_names, v["minigame"], d._minigame))
+                return false;
+
+            d._desc = v["desc"].as<std::string>();
+            d._time = v["time"].as<float>();
+
+            if(v.has("sound"))
+            {
+                d._sound = v["sound"].as<std::string>();
+
+                if(!sound_exists(d._sound))
+                {
+                    std::cerr << "rituals: unknown sound \"" << d._sound
+                              << "\"\n";
+                    return false;
+                }
+            }
+
+            auto vec([](const ssvj::Val& x)
+                {
+                    return vec2f{x[0].as<float>(), x[1].as<float>()};
+                });
+
+            if(v.has("points"))
+            {
+                for(const auto& p : v["points"].forArr())
+                    d._points.push_back({vec(p), p[2].as<float>()});
+            }
+
+            if(v.has("targets"))
+            {
+                for(const auto& t : v["targets"].forArr())
+                    d._targets.emplace_back(vec(t));
+            }
+
+            if(v.has("draggables"))
+            {
+                for(const auto& t : v["draggables"].forArr())
+                    d._draggables.emplace_back(vec(t));
+            }
+
+            if(v.has("scatter"))
+            {
+                d._scatter._count = v["scatter"][0].as<int>();
+                d._scatter._margin = v["scatter"][1].as<float>();
+            }
+
+            return true;
+        }
+
+    public:
+        /// @brief Parses `json`, skipping (and reporting) invalid rituals.
+        /// `sound_exists(name)` tells whether a sound name is valid.
+        template <typename TF>
+        ritual_catalogue(const std::string& json, TF&& sound_exists)
+        {
+            if(json.empty())
+            {
+                std::cerr << "rituals: empty catalogue\n";
+                return;
+            }
+
+            auto root(ssvj::fromStr(json));
+
+            for(const auto& r : root["rituals"].forArr())
+            {
+                ritual_def d;
+                if(parse(r, sound_exists, d)) _defs.emplace_back(std::move(d));
+            }
+        }
+
+        const auto& defs() const noexcept { return _defs; }
+    };
+}
+GGJ16_NAMESPACE_END
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "base.hpp"
+#include "game.hpp"
+
+#include "battle/stat.hpp"
+#include "battle/battle_action.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief Gameplay-relevant part of a ritual, independent from its
+    /// minigame. Shared by the game and the headless simulator.
+    struct ritual_spec
+    {
+        ritual_id _id;
+        const char* _label;
+        stat_value _req_mana;
+        battle_action _action;
+    };
+
+    namespace ritual_specs
+    {
+        constexpr ritual_spec fireball{0, "Fireball", 15,
+            {{{{battle_op_type::damage_enemy, 20},
+                {battle_op_type::damage_enemy_shield, 5}}}}};
+
+        constexpr ritual_spec rend_shield{1, "Rend shield", 20,
+            {{{{battle_op_type::damage_enemy, 5},
+                {battle_op_type::damage_enemy_shield, 25}}}}};
+
+        constexpr ritual_spec obliterate{2, "Obliterate", 50,
+            {{{{battle_op_type::damage_enemy_shield, 20},
+                {battle_op_type::damage_enemy, 60}}}}};
+
+        constexpr ritual_spec heal{3, "Heal", 30,
+            {{{{battle_op_type::damage_player_shield, 10},
+                {battle_op_type::heal_player, 35}}}}};
+
+        constexpr ritual_spec repair_shield{4, "Repair shield", 40,
+            {{{{battle_op_type::damage_player, 5},
+                {battle_op_type::heal_player_shield, 25}}}}};
+
+        constexpr ritual_spec restore_mana{5, "Restore mana", 0,
+            {{{{battle_op_type::restore_player_mana, 0},
+                {battle_op_type::none, 0}}}}};
+
+        constexpr std::array<const ritual_spec*, 6> all{{&fireball,
+            &rend_shield, &obliterate, &heal, &repair_shield, &restore_mana}};
+
+        /// @brief The built-in spec with id `id`, or `nullptr`.
+        inline const ritual_spec* find(ritual_id id) noexcept
+        {
+            for(auto s : all)
+                if(s->_id == id) return s;
+
+            return nullptr;
+        }
+    }
+}
+GGJ16_NAMESPACE_END
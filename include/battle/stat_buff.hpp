@@ -4,24 +4,48 @@
 #include "game.hpp"
 
 #include "battle/stat.hpp"
-#include "battle/character_stats.hpp"
 #include "battle/stat_effect.hpp"
 #include "battle/targeted_stat_effect.hpp"
 
 GGJ16_NAMESPACE
 {
+    /// @brief Set of `targeted_stat_effect`s, applied in order. Effects are
+    /// fused into one `stat_transform` per stat when added, so `compute` is
+    /// a single branch-free pass over the `stat_array`.
     class stat_buff
     {
     private:
-        std::vector<targeted_stat_effect> _effects;
+        std::array<stat_transform, stat_count> _transforms;
 
     public:
-        auto compute(stat_array array)
+        stat_buff() = default;
+
+        stat_buff(std::initializer_list<targeted_stat_effect> effects) noexcept
+        {
+            for(const auto& e : effects) add(e);
+        }
+
+        void add(const targeted_stat_effect& e) noexcept
+        {
+            _transforms[vrmc::from_enum(e.target_type())].then(e.effect());
+        }
+
+        /// @brief Appends all the effects of `b`.
+        void add(const stat_buff& b) noexcept
+        {
+            for(sz_t k(0); k < stat_count; ++k)
+                _transforms[k].then(b._transforms[k]);
+        }
+
+        const auto& transform(stat_type t) const noexcept
+        {
+            return _transforms[vrmc::from_enum(t)];
+        }
+
+        auto compute(stat_array array) const noexcept
         {
-            for(const auto& e : _effects)
-            {
-                apply_targeted_stat_effect(e, array);
-            }
+            for(sz_t k(0); k < stat_count; ++k)
+                array[k] = _transforms[k].compute(array[k]);
 
             return array;
         }
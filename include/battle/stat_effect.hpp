@@ -4,25 +4,169 @@
 #include "game.hpp"
 
 #include "battle/stat.hpp"
-#include "battle/character_stats.hpp"
 
 GGJ16_NAMESPACE
 {
-    using stat_effect_fn = std::function<stat(stat)>;
+    enum class stat_op_type
+    {
+        add = 0,
+        mul = 1,
+        set = 2,
+        clamp_min = 3,
+        clamp_max = 4
+    };
 
+    /// @brief Single `(op, operand)` record, applied to one stat.
     class stat_effect
     {
     private:
-        stat_effect_fn _effect_fn;
+        stat_op_type _op;
+        stat_value _operand;
 
     public:
-        stat_effect(const stat_effect_fn& effect_fn) : _effect_fn{effect_fn} {}
-        auto compute(stat s) const { return _effect_fn(s); }
+        constexpr stat_effect(stat_op_type op, stat_value operand) noexcept
+            : _op{op}, _operand{operand}
+        {
+        }
+
+        constexpr const auto& op() const noexcept { return _op; }
+        constexpr const auto& operand() const noexcept { return _operand; }
+
+        constexpr stat compute(stat s) const noexcept
+        {
+            switch(_op)
+            {
+                case stat_op_type::add: return s + _operand;
+                case stat_op_type::mul: return s * _operand;
+                case stat_op_type::set: return _operand;
+                case stat_op_type::clamp_min: return std::max(s, _operand);
+                case stat_op_type::clamp_max: return std::min(s, _operand);
+            }
+
+            return s;
+        }
+    };
+
+    namespace stat_effects
+    {
+        constexpr auto add(stat_value x) noexcept
+        {
+            return stat_effect{stat_op_type::add, x};
+        }
+
+        constexpr auto mul(stat_value x) noexcept
+        {
+            return stat_effect{stat_op_type::mul, x};
+        }
+
+        constexpr auto set(stat_value x) noexcept
+        {
+            return stat_effect{stat_op_type::set, x};
+        }
+
+        constexpr auto clamp_min(stat_value x) noexcept
+        {
+            return stat_effect{stat_op_type::clamp_min, x};
+        }
+
+        constexpr auto clamp_max(stat_value x) noexcept
+        {
+            return stat_effect{stat_op_type::clamp_max, x};
+        }
+    }
+
+    /// @brief Any chain of `stat_effect`s, fused into
+    /// `clamp(s * mul + add, lo, hi)`. Composing effects keeps `lo <= hi`,
+    /// so evaluation is branch-free. Fused results can differ from the
+    /// step-by-step ones by rounding only.
+    class stat_transform
+    {
+    private:
+        static constexpr stat_value inf{
+            std::numeric_limits<stat_value>::infinity()};
+
+        stat_value _mul{1.f};
+        stat_value _add{0.f};
+        stat_value _lo{-inf};
+        stat_value _hi{inf};
+
+    public:
+        constexpr stat_transform() noexcept = default;
+
+        constexpr const auto& mul() const noexcept { return _mul; }
+        constexpr const auto& add() const noexcept { return _add; }
+        constexpr const auto& lo() const noexcept { return _lo; }
+        constexpr const auto& hi() const noexcept { return _hi; }
+
+        /// @brief Appends `e`: the result computes `e(this(s))`.
+        constexpr stat_transform& then(const stat_effect& e) noexcept
+        {
+            const auto x(e.operand());
+
+            switch(e.op())
+            {
+                case stat_op_type::add:
+                    _add += x;
+                    _lo += x;
+                    _hi += x;
+                    break;
+
+                case stat_op_type::mul:
+                    if(x == 0.f) return then(stat_effects::set(0.f));
+
+                    _mul *= x;
+                    _add *= x;
+                    _lo *= x;
+                    _hi *= x;
+
+                    // Negative factors flip the clamp range.
+                    if(x < 0.f)
+                    {
+                        const auto t(_lo);
+                        _lo = _hi;
+                        _hi = t;
+                    }
+                    break;
+
+                case stat_op_type::set:
+                    _mul = 0.f;
+                    _add = x;
+                    _lo = -inf;
+                    _hi = inf;
+                    break;
+
+                case stat_op_type::clamp_min:
+                    _lo = std::max(_lo, x);
+                    _hi = std::max(_hi, x);
+                    break;
+
+                case stat_op_type::clamp_max:
+                    _lo = std::min(_lo, x);
+                    _hi = std::min(_hi, x);
+                    break;
+            }
+
+            return *this;
+        }
+
+        /// @brief Appends `t`: the result computes `t(this(s))`.
+        constexpr stat_transform& then(const stat_transform& t) noexcept
+        {
+            then(stat_effects::mul(t._mul));
+            then(stat_effects::add(t._add));
+            then(stat_effects::clamp_min(t._lo));
+            return then(stat_effects::clamp_max(t._hi));
+        }
+
+        constexpr stat compute(stat s) const noexcept
+        {
+            return std::min(std::max(s * _mul + _add, _lo), _hi);
+        }
     };
 
     /// @brief Applies an effect to a stat, preserving the original stat and
     /// returning a modified copy.
-    auto apply_stat_effect(const stat_effect& e, const stat& s)
+    inline auto apply_stat_effect(const stat_effect& e, const stat& s)
     {
         return e.compute(s);
     }
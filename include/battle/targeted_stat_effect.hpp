@@ -4,7 +4,6 @@
 #include "game.hpp"
 
 #include "battle/stat.hpp"
-#include "battle/character_stats.hpp"
 #include "battle/stat_effect.hpp"
 
 GGJ16_NAMESPACE
@@ -16,22 +15,27 @@ GGJ16_NAMESPACE
         stat_effect _effect;
 
     public:
-        targeted_stat_effect(stat_type target_type, const stat_effect& effect)
+        constexpr targeted_stat_effect(
+            stat_type target_type, const stat_effect& effect) noexcept
             : _target_type{target_type}, _effect{effect}
         {
         }
 
-        void compute(stat_array& array) const
+        constexpr const auto& target_type() const noexcept
         {
-            const auto& s(get_stat(_target_type, array));
+            return _target_type;
+        }
+        constexpr const auto& effect() const noexcept { return _effect; }
 
-            array[vrmc::from_enum(_target_type)] =
-                apply_stat_effect(_effect, s);
+        void compute(stat_array& array) const noexcept
+        {
+            auto& s(get_stat(_target_type, array));
+            s = apply_stat_effect(_effect, s);
         }
     };
 
     /// @brief Applies a targeteted stat effect mutating the array `a`.
-    auto apply_targeted_stat_effect(
+    inline auto apply_targeted_stat_effect(
         const targeted_stat_effect& e, stat_array& a)
     {
         return e.compute(a);
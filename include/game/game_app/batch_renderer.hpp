@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "base/boilerplate.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief Collects the primitives of a layer and draws them with one
+    /// draw call per texture on `flush`. Untextured shapes (fill and
+    /// outline) share a single triangle array; textured quads are grouped
+    /// by texture and drawn on top of the shapes, textures in the order
+    /// they were first used since the last flush.
+    /// Storage is kept between flushes, so a warmed-up batch does not
+    /// allocate.
+    class batch_renderer
+    {
+    private:
+        struct texture_batch
+        {
+            const sf::Texture* _texture;
+            sf::VertexArray _vertices{sf::PrimitiveType::Quads};
+        };
+
+        sf::VertexArray _shapes{sf::PrimitiveType::Triangles};
+        std::vector<texture_batch> _textured;
+        std::vector<sz_t> _textured_order;
+
+        // Per-shape scratch: local points and their outline offsets.
+        std::vector<vec2f> _points;
+        std::vector<vec2f> _outer;
+
+        static auto normal_of(const vec2f& p0, const vec2f& p1) noexcept
+        {
+            vec2f n{p0.y - p1.y, p1.x - p0.x};
+            auto len(std::sqrt(n.x * n.x + n.y * n.y));
+            return len != 0.f ? n / len : n;
+        }
+
+        static auto dot(const vec2f& a, const vec2f& b) noexcept
+        {
+            return a.x * b.x + a.y * b.y;
+        }
+
+        void push_triangle(const vec2f& a, const vec2f& b, const vec2f& c,
+            const sf::Color& color)
+        {
+            _shapes.append({a, color});
+            _shapes.append({b, color});
+            _shapes.append({c, color});
+        }
+
+        /// @brief Offsets every point along the outward normal, like
+        /// `sf::Shape` does for its outline.
+        void compute_outline(const vec2f& center, float thickness)
+        {
+            auto n(_points.size());
+            _outer.clear();
+
+            for(sz_t i(0); i < n; ++i)
+            {
+                const auto& p0(_points[(i + n - 1) % n]);
+                const auto& p1(_points[i]);
+                const auto& p2(_points[(i + 1) % n]);
+
+                auto n1(normal_of(p0, p1));
+                auto n2(normal_of(p1, p2));
+
+                if(dot(n1, center - p1) > 0) n1 = -n1;
+                if(dot(n2, center - p1) > 0) n2 = -n2;
+
+                auto factor(1.f + dot(n1, n2));
+                _outer.emplace_back(p1 + (n1 + n2) / factor * thickness);
+            }
+        }
+
+        auto& batch_for(const sf::Texture& texture)
+        {
+            auto itr(std::find_if(std::begin(_textured), std::end(_textured),
+                [&texture](const auto& b)
+                {
+                    return b._texture == &texture;
+                }));
+
+            if(itr == std::end(_textured))
+            {
+                _textured.push_back({&texture});
+                itr = std::end(_textured) - 1;
+            }
+
+            if(itr->_vertices.getVertexCount() == 0)
+                _textured_order.emplace_back(itr - std::begin(_textured));
+
+            return itr->_vertices;
+        }
+
+    public:
+        /// @brief Adds the fill and outline of an untextured shape, with
+        /// `t` applied on top of the shape's own transform.
+        void add(const sf::Shape& s,
+            const sf::Transform& t = sf::Transform::Identity)
+        {
+            VRM_CORE_ASSERT(s.getTexture() == nullptr);
+
+            auto n(s.getPointCount());
+            if(n < 3) return;
+
+            // Same as `sf::Shape`: a zero-sized shape draws nothing.
+            auto bounds(s.getLocalBounds());
+            if(bounds.width == 0.f && bounds.height == 0.f) return;
+
+            _points.clear();
+            for(sz_t i(0); i < n; ++i) _points.emplace_back(s.getPoint(i));
+
+            vec2f center{bounds.left + bounds.width / 2.f,
+                bounds.top + bounds.height / 2.f};
+
+            auto thickness(s.getOutlineThickness());
+            if(thickness != 0.f) compute_outline(center, thickness);
+
+            // Transform everything to world space once.
+            auto tr(t * s.getTransform());
+            center = tr.transformPoint(center);
+            for(auto& p : _points) p = tr.transformPoint(p);
+            for(auto& p : _outer) p = tr.transformPoint(p);
+
+            const auto& fc(s.getFillColor());
+            if(fc.a != 0)
+                for(sz_t i(0); i < n; ++i)
+                    push_triangle(center, _points[i], _points[(i + 1) % n], fc);
+
+            if(thickness == 0.f) return;
+
+            const auto& oc(s.getOutlineColor());
+            for(sz_t i(0); i < n; ++i)
+            {
+                auto j((i + 1) % n);
+                push_triangle(_points[i], _outer[i], _points[j], oc);
+                push_triangle(_outer[i], _outer[j], _points[j], oc);
+            }
+
+            _outer.clear();
+        }
+
+        /// @brief Adds a sprite as a textured quad, with `t` applied on top
+        /// of the sprite's own transform.
+        void add(const sf::Sprite& s,
+            const sf::Transform& t = sf::Transform::Identity)
+        {
+            VRM_CORE_ASSERT(s.getTexture() != nullptr);
+
+            auto tr(t * s.getTransform());
+            auto b(s.getLocalBounds());
+            sf::FloatRect uv{s.getTextureRect()};
+            const auto& c(s.getColor());
+
+            add_quad(*s.getTexture(),
+                {{{tr.transformPoint(0, 0), c, {uv.left, uv.top}},
+                    {tr.transformPoint(b.width, 0), c,
+                        {uv.left + uv.width, uv.top}},
+                    {tr.transformPoint(b.width, b.height), c,
+                        {uv.left + uv.width, uv.top + uv.height}},
+                    {tr.transformPoint(0, b.height), c,
+                        {uv.left, uv.top + uv.height}}}});
+        }
+
+        /// @brief Reserves `n` untextured vertices (`n / 3` triangles), in
+        /// world space, for the caller to fill in. The pointer is valid
+        /// until the next addition.
+        sf::Vertex* append_triangles(sz_t n)
+        {
+            VRM_CORE_ASSERT_OP(n % 3, ==, 0);
+
+            auto first(_shapes.getVertexCount());
+            _shapes.resize(first + n);
+            return &_shapes[first];
+        }
+
+        /// @brief Adds a textured quad, in world space.
+        void add_quad(
+            const sf::Texture& texture, const std::array<sf::Vertex, 4>& q)
+        {
+            auto& va(batch_for(texture));
+            for(const auto& v : q) va.append(v);
+        }
+
+        /// @brief Draws everything added since the last flush.
+        void flush(sf::RenderTarget& rt)
+        {
+            if(_shapes.getVertexCount() > 0)
+            {
+                rt.draw(_shapes);
+                _shapes.clear();
+            }
+
+            for(auto i : _textured_order)
+            {
+                auto& b(_textured[i]);
+                rt.draw(b._vertices, sf::RenderStates{b._texture});
+                b._vertices.clear();
+            }
+
+            _textured_order.clear();
+        }
+    };
+}
+GGJ16_NAMESPACE_END
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "base/boilerplate.hpp"
+#include "game/game_app/batch_renderer.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief Outlined circles stored as plain arrays, one per attribute,
+    /// so updates are tight loops over floats and colors. All circles share
+    /// one outline style. Geometry is only computed by `add_to`, once per
+    /// frame, with the same tessellation as `sf::CircleShape`. Circles with
+    /// a radius of zero draw nothing.
+    /// Positions and radii are also kept as of the previous simulation step,
+    /// so that drawing can interpolate between steps.
+    class circle_store
+    {
+    public:
+        static constexpr sz_t segment_count{30};
+
+    private:
+        std::vector<vec2f> _positions;
+        std::vector<float> _radii;
+        std::vector<sf::Color> _fills;
+        std::vector<std::uint8_t> _states;
+
+        std::vector<vec2f> _prev_positions;
+        std::vector<float> _prev_radii;
+
+        float _outline_thickness;
+        sf::Color _outline_color;
+
+        static const auto& unit_circle() noexcept
+        {
+            static const auto result([]
+                {
+                    // Same layout as `sf::CircleShape`: first point on top.
+                    std::array<vec2f, segment_count> r;
+                    const float pi{3.141592654f};
+
+                    for(sz_t i(0); i < segment_count; ++i)
+                    {
+                        auto a(i * 2.f * pi / segment_count - pi / 2.f);
+                        r[i] = vec2f{std::cos(a), std::sin(a)};
+                    }
+
+                    return r;
+                }());
+
+            return result;
+        }
+
+        /// @brief Distance of the outline's outer points from the edge, per
+        /// unit of thickness: the miter of a regular polygon.
+        static auto miter() noexcept
+        {
+            return 1.f / std::cos(3.141592654f / segment_count);
+        }
+
+    public:
+        circle_store(float outline_thickness, const sf::Color& outline_color)
+            : _outline_thickness{outline_thickness},
+              _outline_color{outline_color}
+        {
+        }
+
+        /// @brief Returns the index of the new circle.
+        auto add(const vec2f& position, float radius, const sf::Color& fill,
+            std::uint8_t state = 0)
+        {
+            _positions.emplace_back(position);
+            _radii.emplace_back(radius);
+            _fills.emplace_back(fill);
+            _states.emplace_back(state);
+            _prev_positions.emplace_back(position);
+            _prev_radii.emplace_back(radius);
+            return _positions.size() - 1;
+        }
+
+        void reserve(sz_t n)
+        {
+            _positions.reserve(n);
+            _radii.reserve(n);
+            _fills.reserve(n);
+            _states.reserve(n);
+            _prev_positions.reserve(n);
+            _prev_radii.reserve(n);
+        }
+
+        /// @brief Removes every circle, keeping the storage.
+        void clear() noexcept
+        {
+            _positions.clear();
+            _radii.clear();
+            _fills.clear();
+            _states.clear();
+            _prev_positions.clear();
+            _prev_radii.clear();
+        }
+
+        /// @brief Records the current positions and radii as the previous
+        /// step's. Call before every simulation step.
+        void store_previous()
+        {
+            _prev_positions = _positions;
+            _prev_radii = _radii;
+        }
+
+        auto size() const noexcept { return _positions.size(); }
+
+        auto& positions() noexcept { return _positions; }
+        const auto& positions() const noexcept { return _positions; }
+
+        auto& radii() noexcept { return _radii; }
+        const auto& radii() const noexcept { return _radii; }
+
+        auto& fills() noexcept { return _fills; }
+        const auto& fills() const noexcept { return _fills; }
+
+        /// @brief Free for the owner to use, e.g. as a hit flag.
+        auto& states() noexcept { return _states; }
+        const auto& states() const noexcept { return _states; }
+
+        /// @brief Tessellates every visible circle into `b`'s shapes, `alpha`
+        /// of the way from the previous step to the current one.
+        void add_to(batch_renderer& b, float alpha = 1.f) const
+        {
+            constexpr auto n(segment_count);
+            const auto& unit(unit_circle());
+
+            auto outlined(_outline_thickness != 0.f);
+            auto per_circle(n * 3 + (outlined ? n * 6 : 0));
+
+            auto radius_of([this, alpha](sz_t i)
+                {
+                    const auto& r0(_prev_radii[i]);
+                    return r0 + (_radii[i] - r0) * alpha;
+                });
+
+            sz_t visible{0};
+            for(sz_t i(0); i < _radii.size(); ++i)
+                if(radius_of(i) > 0.f) ++visible;
+
+            if(visible == 0) return;
+
+            auto v(b.append_triangles(visible * per_circle));
+            auto outline_offset(_outline_thickness * miter());
+
+            std::array<vec2f, n> inner, outer;
+
+            for(sz_t i(0); i < _positions.size(); ++i)
+            {
+                auto r(radius_of(i));
+                if(r <= 0.f) continue;
+
+                auto c(_prev_positions[i] +
+                       (_positions[i] - _prev_positions[i]) * alpha);
+                const auto& fc(_fills[i]);
+
+                for(sz_t k(0); k < n; ++k) inner[k] = c + unit[k] * r;
+
+                for(sz_t k(0); k < n; ++k)
+                {
+                    auto j((k + 1) % n);
+                    *v++ = sf::Vertex{c, fc};
+                    *v++ = sf::Vertex{inner[k], fc};
+                    *v++ = sf::Vertex{inner[j], fc};
+                }
+
+                if(!outlined) continue;
+
+                for(sz_t k(0); k < n; ++k)
+                    outer[k] = inner[k] + unit[k] * outline_offset;
+
+                const auto& oc(_outline_color);
+                for(sz_t k(0); k < n; ++k)
+                {
+                    auto j((k + 1) % n);
+                    *v++ = sf::Vertex{inner[k], oc};
+                    *v++ = sf::Vertex{outer[k], oc};
+                    *v++ = sf::Vertex{inner[j], oc};
+                    *v++ = sf::Vertex{outer[k], oc};
+                    *v++ = sf::Vertex{outer[j], oc};
+                    *v++ = sf::Vertex{inner[j], oc};
+                }
+            }
+        }
+    };
+}
+GGJ16_NAMESPACE_END
@@ -1,6 +1,13 @@
 #pragma once
 
+#include <fstream>
 #include "base/boilerplate.hpp"
+#include "game/game_app/batch_renderer.hpp"
+#include "game/game_app/circle_store.hpp"
+#include "game/game_app/glyph_run.hpp"
+#include "game/game_app/hit_grid.hpp"
+#include "game/game_app/music_streamer.hpp"
+#include "game/game_app/profiler_overlay.hpp"
 
 GGJ16_NAMESPACE
 {
@@ -8,8 +15,23 @@ GGJ16_NAMESPACE
     {
         constexpr sz_t width{1024};
         constexpr sz_t height{768};
+
+        // Screens are updated in steps of this many frames (of 1/60 s),
+        // whatever the render rate.
+        constexpr ft sim_step{0.5f};
+
+        // Longer frames are clamped: the game slows down instead of
+        // stepping ever more to catch up.
+        constexpr ft max_frame_time{15.f};
     }
 
+    enum class render_mode
+    {
+        capped,
+        uncapped,
+        vsync
+    };
+
     class game_app;
 
     class game_screen
@@ -56,7 +78,30 @@ GGJ16_NAMESPACE
             game_screen_storage _screen_storage;
             game_screen_stack _screen_stack;
 
+            // Full-screen quad drawn between stacked screens. Only its
+            // color changes, so drawing allocates nothing.
+            sf::VertexArray _block{sf::PrimitiveType::Quads, 4};
+
+            void init_block() noexcept
+            {
+                constexpr float w(game_constants::width);
+                constexpr float h(game_constants::height);
+
+                _block[0].position = vec2f(0, 0);
+                _block[1].position = vec2f(w, 0);
+                _block[2].position = vec2f(w, h);
+                _block[3].position = vec2f(0, h);
+            }
+
+            void set_block_opacity(float opacity) noexcept
+            {
+                sf::Color c{0, 0, 0, static_cast<sf::Uint8>(opacity)};
+                for(sz_t i(0); i < 4; ++i) _block[i].color = c;
+            }
+
         public:
+            game_screen_manager() noexcept { init_block(); }
+
             auto has_any_screen() const noexcept
             {
                 return !_screen_stack.empty();
@@ -76,6 +121,8 @@ GGJ16_NAMESPACE
 
             void update(ft dt) noexcept
             {
+                GGJ16_PROFILE_SCOPE("game_screen_manager::update");
+
                 ssvu::eraseRemoveIf(_screen_stack, [](const auto& s)
                     {
                         return s->dead();
@@ -90,44 +137,25 @@ GGJ16_NAMESPACE
             }
             void draw(sf::RenderTarget& rt) noexcept
             {
-                if(!has_any_screen()) return;
+                GGJ16_PROFILE_SCOPE("game_screen_manager::draw");
 
-                std::vector<std::function<void()>> to_draw;
-                to_draw.emplace_back([this]
-                    {
-                        current_screen().draw();
-                    });
+                if(!has_any_screen()) return;
 
-                if(_screen_stack.size() > 1 && current_screen().pass_through())
+                // A pass-through screen is drawn over the whole stack, with
+                // every lower screen dimmed by its own opacity block.
+                if(current_screen().pass_through())
                 {
-                    for(int i(_screen_stack.size() - 2); i >= 0; --i)
+                    for(sz_t i(0); i + 1 < _screen_stack.size(); ++i)
                     {
                         auto isc(_screen_stack[i]);
+                        isc->draw();
 
-                        sf::RectangleShape block;
-                        block.setPosition(vec2f(0, 0));
-                        block.setSize(vec2f(
-                            game_constants::width, game_constants::height));
-                        block.setFillColor(sf::Color{0, 0, 0,
-                            static_cast<sf::Uint8>(isc->opacity_block())});
-
-                        to_draw.emplace_back([this, block, &rt]
-                            {
-                                rt.draw(block);
-                            });
-
-                        to_draw.emplace_back([this, isc]
-                            {
-                                isc->draw();
-                            });
+                        set_block_opacity(isc->opacity_block());
+                        rt.draw(_block);
                     }
                 }
 
-                for(auto itr(std::rbegin(to_draw)); itr != std::rend(to_draw);
-                    ++itr)
-                {
-                    (*itr)();
-                }
+                current_screen().draw();
             }
 
             template <typename T, typename... Ts>
@@ -161,17 +189,32 @@ GGJ16_NAMESPACE
 
     private:
         using this_type = game_app;
-        sf::Sound music;
+        music_streamer _music;
 
         impl::game_screen_manager _screen_manager;
+        batch_renderer _batch;
+
+        // Cosmetic only: camera shake never affects gameplay.
+        rng_t _fx_rng{std::random_device{}()};
+
+        // Mouse position in world space, sampled once per frame.
+        vec2f _mp;
+
+        // Time not yet simulated, less than a step after every frame.
+        ft _sim_accumulator{0};
+        float _sim_alpha{1.f};
+
+        render_mode _render_mode{render_mode::capped};
+
+#if defined(GGJ16_PROFILE)
+        // Needs a font, so it is created by `enable_profiler_overlay`.
+        std::unique_ptr<profiler_overlay> _profiler_overlay;
+#endif
 
     public:
-        void setup_music(sf::SoundBuffer* b)
-        {
-            music.setBuffer(*b);
-            music.setLoop(true);
-            music.play();
-        }
+        /// @brief Streams `path` in a loop, crossfading from the music
+        /// playing before.
+        void setup_music(const std::string& path) { _music.play(path); }
 
     private:
         void init_loops()
@@ -180,7 +223,22 @@ GGJ16_NAMESPACE
             auto orig_camera_pos = _camera.getCenter();
             state().onUpdate += [this, orig_camera_pos](ft dt)
             {
-                _screen_manager.update(dt);
+                GGJ16_PROFILE_SCOPE("game_app::update");
+
+                _mp = _camera.getMousePosition();
+
+                const auto& step(game_constants::sim_step);
+                _sim_accumulator +=
+                    std::min(dt, game_constants::max_frame_time);
+
+                while(_sim_accumulator >= step)
+                {
+                    _screen_manager.update(step);
+                    _sim_accumulator -= step;
+                }
+
+                _sim_alpha = _sim_accumulator / step;
+                _music.update(dt);
 
                 if(_shake > 1.f)
                 {
@@ -189,8 +247,8 @@ GGJ16_NAMESPACE
 
                     _camera.setCenter(
                         orig_camera_pos +
-                        vec2f{ssvu::getRndR(-_shake, _shake + 0.1f),
-                            ssvu::getRndR(-_shake, _shake + 0.1f)});
+                        vec2f{_fx_rng.range(-_shake, _shake + 0.1f),
+                            _fx_rng.range(-_shake, _shake + 0.1f)});
                 }
                 else
                 {
@@ -203,20 +261,105 @@ GGJ16_NAMESPACE
 
             state().onDraw += [this]
             {
-                _camera.template apply<int>();
-                _screen_manager.draw(window());
-                _camera.unapply();
+                {
+                    GGJ16_PROFILE_SCOPE("game_app::draw");
+
+                    _camera.template apply<int>();
+                    _screen_manager.draw(window());
+                    _camera.unapply();
+
+#if defined(GGJ16_PROFILE)
+                    if(_profiler_overlay != nullptr)
+                    {
+                        _profiler_overlay->update();
+                        render(*_profiler_overlay);
+                    }
+#endif
+                }
+
+#if defined(GGJ16_PROFILE)
+                profiler::frames().mark();
+#endif
             };
         }
 
+        void init_profiler_inputs()
+        {
+#if defined(GGJ16_PROFILE)
+            // F3: toggle the frame-time overlay.
+            state().addInput({{k_key::F3}}, [this](ft)
+                {
+                    if(_profiler_overlay == nullptr) return;
+
+                    auto& v(_profiler_overlay->visible());
+                    v = !v;
+                },
+                input_type::Once);
+
+            // F4: export the recorded zones, for chrome://tracing.
+            state().addInput({{k_key::F4}}, [](ft)
+                {
+                    std::ofstream os{"trace.json"};
+                    profiler::export_chrome_trace(os);
+                },
+                input_type::Once);
+#endif
+        }
+
+        void init_render_inputs()
+        {
+            // F5: cycle between capped, uncapped and vsync rendering.
+            state().addInput({{k_key::F5}}, [this](ft)
+                {
+                    auto next((vrmc::to_int(_render_mode) + 1) % 3);
+                    set_render_mode(render_mode(next));
+                },
+                input_type::Once);
+        }
+
     public:
         inline game_app(ssvs::GameWindow& window) noexcept
             : boilerplate::app{window}
         {
             init_loops();
+            init_profiler_inputs();
+            init_render_inputs();
+        }
+
+        /// @brief Only changes how often frames are drawn: the simulation
+        /// always runs at a fixed rate.
+        void set_render_mode(render_mode m)
+        {
+            _render_mode = m;
+            window().setVsync(m == render_mode::vsync);
+            window().setFPSLimited(m == render_mode::capped);
+        }
+
+        const auto& current_render_mode() const noexcept
+        {
+            return _render_mode;
+        }
+
+        /// @brief How far the current frame is between the last two
+        /// simulation steps, from `0` (the previous one) to `1` (the last
+        /// one). Drawing code interpolates moving state with it.
+        const auto& sim_alpha() const noexcept { return _sim_alpha; }
+
+#if defined(GGJ16_PROFILE)
+        void enable_profiler_overlay(const ssvs::BitmapFont& font)
+        {
+            _profiler_overlay = std::make_unique<profiler_overlay>(font);
         }
+#endif
+
+        auto& batch() noexcept { return _batch; }
+
+        /// @brief Draws the primitives batched so far, closing the current
+        /// layer.
+        void flush_batch() { _batch.flush(_window); }
 
-        auto mp() const noexcept { return _camera.getMousePosition(); }
+        /// @brief Mouse position, as sampled at the start of the update.
+        const auto& mp() const noexcept { return _mp; }
 
         auto lb_down() const noexcept
         {
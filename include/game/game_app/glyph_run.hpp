@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+#include "base/boilerplate.hpp"
+#include "game/game_app/batch_renderer.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief Single-color bitmap text whose glyph quads are cached in
+    /// local space. They are rebuilt only when the font, string or
+    /// tracking change; position and scale come from the transform.
+    /// Drawn through a `batch_renderer`, so every run sharing a font costs
+    /// one draw call.
+    class glyph_run : public sf::Transformable
+    {
+    private:
+        const ssvs::BitmapFont* _font;
+        std::string _str;
+        int _tracking{0};
+        sf::Color _color{sfc::White};
+
+        mutable std::vector<sf::Vertex> _quads;
+        mutable sf::FloatRect _bounds;
+        mutable bool _dirty{true};
+
+        /// @brief Same layout as `ssvs::BitmapText`: fixed-size cells,
+        /// `tracking` pixels apart.
+        void rebuild() const
+        {
+            _dirty = false;
+            _quads.clear();
+
+            auto cw(vrmc::to_int(_font->getCellWidth()));
+            auto ch(vrmc::to_int(_font->getCellHeight()));
+            int ix{0}, iy{0}, max_x{0};
+
+            for(auto c : _str)
+            {
+                if(c == '\n')
+                {
+                    ix = 0;
+                    ++iy;
+                    continue;
+                }
+
+                auto r(_font->getGlyphRect(c));
+                float x(ix * (cw + _tracking)), y(iy * ch);
+                float u(r.left), v(r.top);
+
+                _quads.push_back({{x, y}, _color, {u, v}});
+                _quads.push_back({{x + cw, y}, _color, {u + cw, v}});
+                _quads.push_back({{x + cw, y + ch}, _color, {u + cw, v + ch}});
+                _quads.push_back({{x, y + ch}, _color, {u, v + ch}});
+
+                ++ix;
+                max_x = std::max(max_x, vrmc::to_int(x) + cw);
+            }
+
+            _bounds = sf::FloatRect{0.f, 0.f, float(max_x),
+                _str.empty() ? 0.f : float((iy + 1) * ch)};
+        }
+
+    public:
+        glyph_run(const ssvs::BitmapFont& font, int tracking = 0) noexcept
+            : _font{&font}, _tracking{tracking}
+        {
+        }
+
+        void set_string(const std::string& x)
+        {
+            if(_str == x) return;
+
+            _str = x;
+            _dirty = true;
+        }
+
+        void set_tracking(int x) noexcept
+        {
+            if(_tracking == x) return;
+
+            _tracking = x;
+            _dirty = true;
+        }
+
+        void set_color(const sf::Color& x) noexcept
+        {
+            if(_color == x) return;
+
+            _color = x;
+            _dirty = true;
+        }
+
+        const auto& str() const noexcept { return _str; }
+
+        const auto& local_bounds() const
+        {
+            if(_dirty) rebuild();
+            return _bounds;
+        }
+
+        /// @brief Moves the origin to the center of the text.
+        void center_origin()
+        {
+            const auto& b(local_bounds());
+            setOrigin(b.width / 2.f, b.height / 2.f);
+        }
+
+        void add_to(batch_renderer& b,
+            const sf::Transform& t = sf::Transform::Identity) const
+        {
+            if(_dirty) rebuild();
+
+            auto tr(t * getTransform());
+            const auto& texture(_font->getTexture());
+
+            for(sz_t i(0); i < _quads.size(); i += 4)
+            {
+                std::array<sf::Vertex, 4> q{
+                    {_quads[i], _quads[i + 1], _quads[i + 2], _quads[i + 3]}};
+
+                for(auto& v : q) v.position = tr.transformPoint(v.position);
+                b.add_quad(texture, q);
+            }
+        }
+    };
+}
+GGJ16_NAMESPACE_END
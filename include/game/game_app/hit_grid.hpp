@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "base/boilerplate.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief Uniform grid of circles, for point queries. Each circle is
+    /// listed in every cell its bounding box overlaps, so a query only
+    /// visits the circles of one cell. Circles outside the grid's area are
+    /// clamped to its border cells. Rebuilt lazily after `add` or `clear`.
+    class hit_grid
+    {
+    private:
+        struct item
+        {
+            sz_t _id;
+            vec2f _center;
+            float _radius;
+        };
+
+        float _cell_size;
+        int _cols, _rows;
+        std::vector<item> _items;
+        bool _dirty{true};
+
+        // Items of cell `c` are `_cell_items[_cell_begin[c]..[c + 1]]`.
+        std::vector<sz_t> _cell_begin;
+        std::vector<sz_t> _cell_items;
+        std::vector<sz_t> _cursor;
+
+        auto cell_coord(float x, int count) const noexcept
+        {
+            return std::min(count - 1, std::max(0, int(x / _cell_size)));
+        }
+
+        template <typename TF>
+        void for_cells(const item& it, TF&& f) const
+        {
+            auto x0(cell_coord(it._center.x - it._radius, _cols));
+            auto x1(cell_coord(it._center.x + it._radius, _cols));
+            auto y0(cell_coord(it._center.y - it._radius, _rows));
+            auto y1(cell_coord(it._center.y + it._radius, _rows));
+
+            for(auto y(y0); y <= y1; ++y)
+                for(auto x(x0); x <= x1; ++x) f(sz_t(y * _cols + x));
+        }
+
+        void build()
+        {
+            _dirty = false;
+
+            // Counting sort of the items by cell.
+            _cell_begin.assign(_cols * _rows + 1, 0);
+
+            for(const auto& it : _items)
+                for_cells(it, [this](sz_t c)
+                    {
+                        ++_cell_begin[c + 1];
+                    });
+
+            for(sz_t c(1); c < _cell_begin.size(); ++c)
+                _cell_begin[c] += _cell_begin[c - 1];
+
+            _cell_items.resize(_cell_begin.back());
+            _cursor.assign(std::begin(_cell_begin), std::end(_cell_begin) - 1);
+
+            for(sz_t i(0); i < _items.size(); ++i)
+                for_cells(_items[i], [this, i](sz_t c)
+                    {
+                        _cell_items[_cursor[c]++] = i;
+                    });
+        }
+
+    public:
+        hit_grid(vec2f size, float cell_size = 64.f)
+            : _cell_size{cell_size},
+              _cols{std::max(1, int(std::ceil(size.x / cell_size)))},
+              _rows{std::max(1, int(std::ceil(size.y / cell_size)))}
+        {
+        }
+
+        void clear() noexcept
+        {
+            _items.clear();
+            _dirty = true;
+        }
+
+        void add(sz_t id, vec2f center, float radius)
+        {
+            _items.push_back({id, center, radius});
+            _dirty = true;
+        }
+
+        /// @brief Calls `f(id)` for every circle containing `p`.
+        template <typename TF>
+        void for_hits(vec2f p, TF&& f)
+        {
+            if(_dirty) build();
+
+            auto c(cell_coord(p.y, _rows) * _cols + cell_coord(p.x, _cols));
+
+            for(auto i(_cell_begin[c]); i < _cell_begin[c + 1]; ++i)
+            {
+                const auto& it(_items[_cell_items[i]]);
+                auto d(p - it._center);
+
+                if(d.x * d.x + d.y * d.y < it._radius * it._radius)
+                    f(it._id);
+            }
+        }
+    };
+}
+GGJ16_NAMESPACE_END
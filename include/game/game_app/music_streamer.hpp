@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+#include "base/boilerplate.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief Streams looping music from disk, crossfading when the track
+    /// is (re)started. Only two streams are ever open: the one fading in
+    /// and the one fading out.
+    class music_streamer
+    {
+    private:
+        std::array<sf::Music, 2> _tracks;
+        sz_t _current{0};
+        float _volume{100.f};
+
+        // Crossfade progress, from `0` (just started) to `1` (done).
+        float _fade{1.f};
+        ft _fade_duration{0.f};
+
+        auto& current() noexcept { return _tracks[_current]; }
+        auto& previous() noexcept { return _tracks[1 - _current]; }
+
+        void apply_volumes()
+        {
+            // Equal-power curve: no loudness dip halfway through.
+            current().setVolume(_volume * std::sqrt(_fade));
+            previous().setVolume(_volume * std::sqrt(1.f - _fade));
+        }
+
+    public:
+        /// @brief Starts `path`, fading it in over `fade_duration` while the
+        /// current track fades out.
+        bool play(const std::string& path, ft fade_duration = 60.f)
+        {
+            auto& m(_tracks[1 - _current]);
+            if(!m.openFromFile(path)) return false;
+
+            _current = 1 - _current;
+            m.setLoop(true);
+            m.play();
+
+            _fade_duration = fade_duration;
+            _fade = fade_duration > 0.f ? 0.f : 1.f;
+            apply_volumes();
+
+            if(_fade >= 1.f) previous().stop();
+            return true;
+        }
+
+        void update(ft dt)
+        {
+            if(_fade >= 1.f) return;
+
+            _fade = std::min(1.f, _fade + dt / _fade_duration);
+            apply_volumes();
+
+            if(_fade >= 1.f) previous().stop();
+        }
+
+        void set_volume(float x)
+        {
+            _volume = x;
+            apply_volumes();
+        }
+    };
+}
+GGJ16_NAMESPACE_END
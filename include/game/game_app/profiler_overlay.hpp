@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include "base/boilerplate.hpp"
+
+GGJ16_NAMESPACE
+{
+    /// @brief Frame-time graph and percentiles of `profiler::frames()`,
+    /// drawn in screen space on top of everything else.
+    class profiler_overlay : public sf::Drawable
+    {
+    private:
+        static constexpr sz_t refresh_interval{30};
+        static constexpr float graph_h{60.f};
+        static constexpr float graph_ms_max{50.f};
+        static constexpr float margin{10.f};
+
+        ssvs::BitmapText _txt;
+        sf::RectangleShape _bg;
+        sf::VertexArray _graph{sf::PrimitiveType::Lines};
+        sz_t _frames_since_refresh{refresh_interval};
+        bool _visible{false};
+
+        static auto fmt_ms(float x)
+        {
+            auto tenths(vrmc::to_int(x * 10.f + 0.5f));
+            return std::to_string(tenths / 10) + "." +
+                   std::to_string(tenths % 10);
+        }
+
+        void refresh_text()
+        {
+            const auto& f(profiler::frames());
+
+            _txt.setString("p50 " + fmt_ms(f.percentile(0.5f)) + "  p90 " +
+                           fmt_ms(f.percentile(0.9f)) + "  p99 " +
+                           fmt_ms(f.percentile(0.99f)) + "  max " +
+                           fmt_ms(f.percentile(1.f)) + " ms");
+        }
+
+        void refresh_graph()
+        {
+            const auto& f(profiler::frames());
+
+            _graph.clear();
+
+            float x{margin};
+            auto bottom(margin + graph_h);
+
+            f.for_frames([&](float ms)
+                {
+                    auto h(std::min(ms, graph_ms_max) / graph_ms_max * graph_h);
+                    auto c(ms > 33.4f ? sfc::Red : ms > 16.7f ? sfc::Yellow
+                                                               : sfc::Green);
+
+                    _graph.append({vec2f{x, bottom}, c});
+                    _graph.append({vec2f{x, bottom - h}, c});
+                    x += 1.f;
+                });
+        }
+
+    public:
+        profiler_overlay(const ssvs::BitmapFont& font) : _txt{font}
+        {
+            _txt.setTracking(-3);
+            _txt.setScale(vec2f(2.f, 2.f));
+            _txt.setPosition(vec2f(margin, margin + graph_h + margin));
+
+            _bg.setPosition(vec2f(0.f, 0.f));
+            _bg.setSize(vec2f(
+                profiler::frame_stats::capacity + margin * 2, graph_h + 50.f));
+            _bg.setFillColor(sf::Color{0, 0, 0, 175});
+        }
+
+        auto& visible() noexcept { return _visible; }
+        const auto& visible() const noexcept { return _visible; }
+
+        /// @brief Call once per frame. The graph follows every frame, the
+        /// text only every `refresh_interval` frames.
+        void update()
+        {
+            if(!_visible) return;
+
+            refresh_graph();
+
+            if(++_frames_since_refresh < refresh_interval) return;
+            _frames_since_refresh = 0;
+            refresh_text();
+        }
+
+        virtual void draw(
+            sf::RenderTarget& target, sf::RenderStates states) const override
+        {
+            if(!_visible) return;
+
+            target.draw(_bg, states);
+            target.draw(_graph, states);
+            target.draw(_txt, states);
+        }
+    };
+}
+GGJ16_NAMESPACE_END
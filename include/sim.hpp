@@ -0,0 +1,8 @@
+#pragma once
+
+#include "sim/battle_sim.hpp"
+#include "sim/simd.hpp"
+#include "sim/battle_kernels.hpp"
+#include "sim/battle_soa.hpp"
+#include "sim/work_stealing.hpp"
+#include "sim/gauntlet_runner.hpp"
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "base.hpp"
+#include "sim/simd.hpp"
+
+GGJ16_NAMESPACE
+{
+    namespace sim
+    {
+        /// @brief Lane-wise versions of the `battle_context_t` stat
+        /// mutations. Every kernel performs the same floating point
+        /// operations, in the same order, as its scalar counterpart; lanes
+        /// with a zero amount are left unchanged, whatever their stats (a
+        /// zero `maxshield` would otherwise turn health into NaN).
+        namespace kernels
+        {
+            namespace impl
+            {
+                /// @brief `result` on the lanes where `x` is non-zero, `v`
+                /// on the others.
+                template <typename TOps, typename T>
+                inline auto if_nonzero(T x, T result, T v) noexcept
+                {
+                    return TOps::select(
+                        TOps::ne(x, TOps::set1(0.f)), result, v);
+                }
+
+                template <typename TOps, typename T>
+                inline auto damage_calc(T h, T s, T ms, T x) noexcept
+                {
+                    using o = TOps;
+
+                    auto sratio(o::div(s, ms));
+                    auto blocked_dmg(o::mul(x, o::mul(sratio, o::set1(0.9f))));
+                    auto dmg(o::sub(x, blocked_dmg));
+
+                    return if_nonzero<o>(
+                        x, o::max(o::sub(h, dmg), o::set1(0.f)), h);
+                }
+
+                template <typename TOps, typename T>
+                inline auto heal(T v, T maxv, T x) noexcept
+                {
+                    return if_nonzero<TOps>(
+                        x, TOps::min(TOps::add(v, x), maxv), v);
+                }
+
+                template <typename TOps, typename T>
+                inline auto damage_clamped(T v, T x) noexcept
+                {
+                    return if_nonzero<TOps>(
+                        x, TOps::max(TOps::sub(v, x), TOps::set1(0.f)), v);
+                }
+
+                template <typename TOps, typename T>
+                inline auto restore(T v, T maxv, T mask) noexcept
+                {
+                    return TOps::select(
+                        TOps::gt(mask, TOps::set1(0.f)), maxv, v);
+                }
+            }
+
+            /// @brief `battle_context_t::damage_calc` over `n` lanes.
+            inline void damage_calc(float* health, const float* shield,
+                const float* maxshield, const float* amount, sz_t n) noexcept
+            {
+                simd::for_lanes(n, [=](auto ops, sz_t i)
+                    {
+                        using o = decltype(ops);
+
+                        o::store(health + i,
+                            impl::damage_calc<o>(o::load(health + i),
+                                     o::load(shield + i), o::load(maxshield + i),
+                                     o::load(amount + i)));
+                    });
+            }
+
+            /// @brief `heal_*_by`/`heal_*_shield_by` over `n` lanes.
+            inline void heal(float* value, const float* maxvalue,
+                const float* amount, sz_t n) noexcept
+            {
+                simd::for_lanes(n, [=](auto ops, sz_t i)
+                    {
+                        using o = decltype(ops);
+
+                        o::store(value + i, impl::heal<o>(o::load(value + i),
+                                                o::load(maxvalue + i),
+                                                o::load(amount + i)));
+                    });
+            }
+
+            /// @brief `damage_*_shield_by` over `n` lanes.
+            inline void damage_clamped(
+                float* value, const float* amount, sz_t n) noexcept
+            {
+                simd::for_lanes(n, [=](auto ops, sz_t i)
+                    {
+                        using o = decltype(ops);
+
+                        o::store(value + i, impl::damage_clamped<o>(
+                                                o::load(value + i),
+                                                o::load(amount + i)));
+                    });
+            }
+
+            /// @brief `restore_*_mana` over the lanes whose `mask` is
+            /// positive.
+            inline void restore(float* value, const float* maxvalue,
+                const float* mask, sz_t n) noexcept
+            {
+                simd::for_lanes(n, [=](auto ops, sz_t i)
+                    {
+                        using o = decltype(ops);
+
+                        o::store(value + i, impl::restore<o>(o::load(value + i),
+                                                o::load(maxvalue + i),
+                                                o::load(mask + i)));
+                    });
+            }
+
+            /// @brief Stat lanes of one side of a batch of battles.
+            struct side_lanes
+            {
+                float* _health;
+                const float* _maxhealth;
+                float* _shield;
+                const float* _maxshield;
+                float* _mana;
+                const float* _maxmana;
+            };
+
+            /// @brief Pending per-lane amounts targeting one side.
+            struct side_op_lanes
+            {
+                float* _damage;
+                float* _heal;
+                float* _shield_damage;
+                float* _shield_heal;
+                float* _restore_mana;
+            };
+
+            /// @brief Applies, in a single pass, all the pending ops of a
+            /// side and clears them. Each lane must hold at most one
+            /// non-zero amount, which makes the result identical to calling
+            /// the matching `battle_context_t` method.
+            inline void apply_side_ops(
+                const side_lanes& s, const side_op_lanes& x, sz_t n) noexcept
+            {
+                simd::for_lanes(n, [&s, &x](auto ops, sz_t i)
+                    {
+                        using o = decltype(ops);
+                        const auto zero(o::set1(0.f));
+
+                        auto h(o::load(s._health + i));
+                        auto sh(o::load(s._shield + i));
+                        auto ms(o::load(s._maxshield + i));
+                        auto m(o::load(s._mana + i));
+
+                        h = impl::damage_calc<o>(
+                            h, sh, ms, o::load(x._damage + i));
+                        h = impl::heal<o>(h, o::load(s._maxhealth + i),
+                            o::load(x._heal + i));
+
+                        sh = impl::damage_clamped<o>(
+                            sh, o::load(x._shield_damage + i));
+                        sh = impl::heal<o>(
+                            sh, ms, o::load(x._shield_heal + i));
+
+                        m = impl::restore<o>(m, o::load(s._maxmana + i),
+                            o::load(x._restore_mana + i));
+
+                        o::store(s._health + i, h);
+                        o::store(s._shield + i, sh);
+                        o::store(s._mana + i, m);
+
+                        o::store(x._damage + i, zero);
+                        o::store(x._heal + i, zero);
+                        o::store(x._shield_damage + i, zero);
+                        o::store(x._shield_heal + i, zero);
+                        o::store(x._restore_mana + i, zero);
+                    });
+            }
+        }
+    }
+}
+GGJ16_NAMESPACE_END
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "base.hpp"
+
+#include "battle/stat.hpp"
+#include "battle/battle.hpp"
+#include "battle/battle_action.hpp"
+#include "battle/ritual_spec.hpp"
+#include "battle/enemy_ai.hpp"
+
+GGJ16_NAMESPACE
+{
+    namespace sim
+    {
+        /// @brief A ritual available to the simulated player: `_weight` is
+        /// the relative chance of choosing it, `_success_chance` the chance
+        /// of winning its minigame.
+        struct sim_ritual
+        {
+            ritual_spec _spec;
+            float _weight;
+            float _success_chance;
+        };
+
+        using sim_ritual_set = std::vector<sim_ritual>;
+
+        inline auto default_rituals()
+        {
+            return sim_ritual_set{
+                {ritual_specs::fireball, 1.f, 0.9f},       // .
+                {ritual_specs::rend_shield, 1.f, 0.75f},   // .
+                {ritual_specs::obliterate, 1.f, 0.5f},     // .
+                {ritual_specs::heal, 1.f, 0.9f},           // .
+                {ritual_specs::repair_shield, 1.f, 0.75f}, // .
+                {ritual_specs::restore_mana, 0.5f, 0.75f}, // .
+            };
+        }
+
+        struct battle_result
+        {
+            bool _player_won;
+            int _turns;
+            stat_value _player_health;
+            stat_value _enemy_health;
+        };
+
+        struct batch_result
+        {
+            sz_t _battles{0};
+            sz_t _wins{0};
+            sz_t _turns{0};
+            double _player_health{0};
+
+            void add(const battle_result& r) noexcept
+            {
+                ++_battles;
+                _wins += r._player_won;
+                _turns += r._turns;
+                _player_health += r._player_health;
+            }
+
+            auto win_rate() const noexcept
+            {
+                return _battles == 0 ? 0.0 : double(_wins) / _battles;
+            }
+
+            auto avg_turns() const noexcept
+            {
+                return _battles == 0 ? 0.0 : double(_turns) / _battles;
+            }
+
+            auto avg_player_health() const noexcept
+            {
+                return _battles == 0 ? 0.0 : _player_health / _battles;
+            }
+        };
+
+        /// @brief Seed of the `idx`-th battle of a batch seeded with
+        /// `seed`.
+        inline rng_t::seed_type battle_seed(
+            rng_t::seed_type seed, std::uint64_t idx) noexcept
+        {
+            return ggj16::impl::splitmix64(seed ^ ggj16::impl::splitmix64(idx));
+        }
+
+        namespace impl
+        {
+            /// @brief Picks a random affordable ritual, weighted by
+            /// `_weight`. Returns `nullptr` if none is affordable. Both
+            /// passes are branch-free, as the pick is unpredictable.
+            inline const sim_ritual* choose_ritual(
+                const sim_ritual_set& rituals, stat_value mana, rng_t& rng)
+            {
+                auto weight([mana](const sim_ritual& r)
+                    {
+                        return r._spec._req_mana <= mana ? r._weight : 0.f;
+                    });
+
+                float total{0.f};
+                for(const auto& r : rituals) total += weight(r);
+
+                if(total <= 0.f) return nullptr;
+
+                const sim_ritual* result{nullptr};
+                auto pick(rng.next_float() * total);
+
+                for(const auto& r : rituals)
+                {
+                    auto w(weight(r));
+                    result = (w > 0.f && pick >= 0.f) ? &r : result;
+                    pick -= w;
+                }
+
+                return result;
+            }
+
+            class battle_driver
+            {
+            private:
+                battle_context_t& _ctx;
+                const sim_ritual_set& _rituals;
+                enemy_ai_fn _ai;
+
+            public:
+                battle_driver(battle_context_t& ctx,
+                    const sim_ritual_set& rituals, enemy_ai_fn ai) noexcept
+                    : _ctx(ctx), _rituals(rituals), _ai{ai}
+                {
+                }
+
+                void player_turn(battle_t&)
+                {
+                    const auto& mana(_ctx.player().stats().mana());
+
+                    auto& rng(_ctx.rng());
+
+                    auto r(choose_ritual(_rituals, mana, rng));
+                    if(r == nullptr) return;
+
+                    const auto& spec(r->_spec);
+                    _ctx.spend_player_mana(spec._req_mana);
+                    _ctx.cast_ritual(spec._id);
+
+                    auto success(rng.next_float() < r->_success_chance);
+                    _ctx.ritual_outcome(spec._id, success);
+
+                    if(success) apply_battle_action(_ctx, spec._action);
+                }
+
+                void enemy_turn(battle_t&)
+                {
+                    const auto& ps(_ctx.player().stats());
+                    const auto& es(_ctx.enemy().stats());
+                    apply_battle_action(_ctx, _ai(ps, es)._action);
+                }
+            };
+        }
+
+        /// @brief Runs complete battles without window, assets or audio.
+        /// The player picks a random affordable ritual every turn and rolls
+        /// its minigame outcome; the enemy uses its regular AI.
+        class battle_simulator
+        {
+        private:
+            sim_ritual_set _rituals;
+            int _max_turns{100};
+
+        public:
+            battle_simulator(sim_ritual_set rituals = default_rituals())
+                : _rituals(std::move(rituals))
+            {
+            }
+
+            auto& rituals() noexcept { return _rituals; }
+            const auto& rituals() const noexcept { return _rituals; }
+
+            auto& max_turns() noexcept { return _max_turns; }
+            const auto& max_turns() const noexcept { return _max_turns; }
+
+            /// @brief Runs a single battle. The same `seed` always yields the
+            /// same result.
+            auto run(const battle_t& battle, enemy_ai_fn ai,
+                rng_t::seed_type seed) const
+            {
+                battle_context_t ctx{battle, seed};
+                impl::battle_driver d{ctx, _rituals, ai};
+                ctx.battle().execute_battle(d, _max_turns);
+
+                const auto& b(ctx.battle());
+                return battle_result{b.enemy_dead(), b.turn(),
+                    b.player().stats().health(), b.enemy().stats().health()};
+            }
+
+            /// @brief Runs `count` battles, the `i`-th one seeded with
+            /// `battle_seed(seed, i)`.
+            auto run_batch(const battle_t& battle, enemy_ai_fn ai, sz_t count,
+                rng_t::seed_type seed) const
+            {
+                batch_result result;
+
+                for(sz_t i(0); i < count; ++i)
+                {
+                    result.add(run(battle, ai, battle_seed(seed, i)));
+                }
+
+                return result;
+            }
+        };
+    }
+}
+GGJ16_NAMESPACE_END
@@ -0,0 +1,375 @@
+#pragma once
+
+#include "base.hpp"
+
+#include "battle/stat.hpp"
+#include "battle/character_stats.hpp"
+#include "battle/battle.hpp"
+#include "battle/battle_action.hpp"
+#include "battle/enemy_ai.hpp"
+#include "sim/battle_kernels.hpp"
+#include "sim/battle_sim.hpp"
+
+GGJ16_NAMESPACE
+{
+    namespace sim
+    {
+        /// @brief Structure-of-arrays state of `size()` battles: one
+        /// contiguous float lane per `stat_type`, for both sides, plus the
+        /// gameplay random stream of every battle.
+        class battle_soa
+        {
+        public:
+            using lane_type = std::vector<float>;
+            using side_type = std::array<lane_type, stat_count>;
+
+        private:
+            sz_t _size{0};
+            side_type _player;
+            side_type _enemy;
+            std::vector<rng_t> _rng;
+
+            static auto gather(const side_type& side, sz_t i) noexcept
+            {
+                stat_array result;
+                for(sz_t k(0); k < stat_count; ++k) result[k] = side[k][i];
+                return character_stats{result};
+            }
+
+        public:
+            const auto& size() const noexcept { return _size; }
+
+            void resize(sz_t n)
+            {
+                _size = n;
+                for(auto& l : _player) l.resize(n);
+                for(auto& l : _enemy) l.resize(n);
+                _rng.resize(n);
+            }
+
+            /// @brief Keeps only the lanes for which `keep(i)` is true,
+            /// preserving their order. Capacity is retained.
+            template <typename TF>
+            void retain(TF&& keep)
+            {
+                sz_t k(0);
+
+                for(sz_t i(0); i < _size; ++i)
+                {
+                    if(!keep(i)) continue;
+
+                    if(k != i)
+                    {
+                        for(auto& l : _player) l[k] = l[i];
+                        for(auto& l : _enemy) l[k] = l[i];
+                        _rng[k] = _rng[i];
+                    }
+
+                    ++k;
+                }
+
+                _size = k;
+            }
+
+            /// @brief Sets every lane to the initial state of `b`. Lane `i`
+            /// is seeded as the `first + i`-th battle of a batch seeded with
+            /// `seed`.
+            void fill(const battle_t& b, rng_t::seed_type seed, sz_t first)
+            {
+                for(sz_t i(0); i < _size; ++i)
+                    _rng[i] = rng_t{battle_seed(seed, first + i), 0};
+
+                const auto& pa(b.player().stats().array());
+                const auto& ea(b.enemy().stats().array());
+
+                for(sz_t k(0); k < stat_count; ++k)
+                {
+                    std::fill(std::begin(_player[k]), std::end(_player[k]), pa[k]);
+                    std::fill(std::begin(_enemy[k]), std::end(_enemy[k]), ea[k]);
+                }
+            }
+
+            auto player(stat_type t) noexcept
+            {
+                return _player[vrmc::from_enum(t)].data();
+            }
+            auto player(stat_type t) const noexcept
+            {
+                return _player[vrmc::from_enum(t)].data();
+            }
+
+            auto enemy(stat_type t) noexcept
+            {
+                return _enemy[vrmc::from_enum(t)].data();
+            }
+            auto enemy(stat_type t) const noexcept
+            {
+                return _enemy[vrmc::from_enum(t)].data();
+            }
+
+            auto& rng(sz_t i) noexcept { return _rng[i]; }
+
+            auto player_stats(sz_t i) const noexcept
+            {
+                return gather(_player, i);
+            }
+            auto enemy_stats(sz_t i) const noexcept { return gather(_enemy, i); }
+        };
+
+        /// @brief Per-lane pending amounts for one op slot of a
+        /// `battle_action`, split by targeted side. Each lane holds at most
+        /// one op, so all of them can be applied by a single fused kernel.
+        class battle_op_lanes
+        {
+        private:
+            enum class column
+            {
+                damage = 0,
+                heal = 1,
+                shield_damage = 2,
+                shield_heal = 3,
+                restore_mana = 4
+            };
+
+            static constexpr sz_t column_count{5};
+
+            using side_type = std::array<std::vector<float>, column_count>;
+
+            side_type _player;
+            side_type _enemy;
+            bool _player_used{false};
+            bool _enemy_used{false};
+
+            void set(side_type& side, bool& used, column c, sz_t lane,
+                float x) noexcept
+            {
+                side[vrmc::from_enum(c)][lane] = x;
+                used = true;
+            }
+
+            static auto op_lanes(side_type& side) noexcept
+            {
+                return kernels::side_op_lanes{side[0].data(), side[1].data(),
+                    side[2].data(), side[3].data(), side[4].data()};
+            }
+
+            static auto stat_lanes(
+                battle_soa& s, float* (battle_soa::*f)(stat_type)) noexcept
+            {
+                using st = stat_type;
+
+                return kernels::side_lanes{(s.*f)(st::health),
+                    (s.*f)(st::maxhealth), (s.*f)(st::shield),
+                    (s.*f)(st::maxshield), (s.*f)(st::mana),
+                    (s.*f)(st::maxmana)};
+            }
+
+        public:
+            void resize(sz_t n)
+            {
+                for(auto& a : _player) a.assign(n, 0.f);
+                for(auto& a : _enemy) a.assign(n, 0.f);
+                _player_used = _enemy_used = false;
+            }
+
+            void add(sz_t lane, const battle_op& op) noexcept
+            {
+                using c = column;
+                auto& p(_player);
+                auto& e(_enemy);
+                auto& pu(_player_used);
+                auto& eu(_enemy_used);
+                auto x(op._amount);
+
+                switch(op._type)
+                {
+                    case battle_op_type::none: break;
+                    case battle_op_type::damage_player:
+                        set(p, pu, c::damage, lane, x);
+                        break;
+                    case battle_op_type::damage_enemy:
+                        set(e, eu, c::damage, lane, x);
+                        break;
+                    case battle_op_type::heal_player:
+                        set(p, pu, c::heal, lane, x);
+                        break;
+                    case battle_op_type::heal_enemy:
+                        set(e, eu, c::heal, lane, x);
+                        break;
+                    case battle_op_type::damage_player_shield:
+                        set(p, pu, c::shield_damage, lane, x);
+                        break;
+                    case battle_op_type::damage_enemy_shield:
+                        set(e, eu, c::shield_damage, lane, x);
+                        break;
+                    case battle_op_type::heal_player_shield:
+                        set(p, pu, c::shield_heal, lane, x);
+                        break;
+                    case battle_op_type::heal_enemy_shield:
+                        set(e, eu, c::shield_heal, lane, x);
+                        break;
+                    case battle_op_type::restore_player_mana:
+                        // `restore_*` ops carry no amount: store a lane mask.
+                        set(p, pu, c::restore_mana, lane, 1.f);
+                        break;
+                }
+            }
+
+            /// @brief Applies and clears all the pending ops.
+            void apply(battle_soa& s)
+            {
+                if(_player_used)
+                {
+                    kernels::apply_side_ops(stat_lanes(s, &battle_soa::player),
+                        op_lanes(_player), s.size());
+                    _player_used = false;
+                }
+
+                if(_enemy_used)
+                {
+                    kernels::apply_side_ops(stat_lanes(s, &battle_soa::enemy),
+                        op_lanes(_enemy), s.size());
+                    _enemy_used = false;
+                }
+            }
+        };
+
+        /// @brief Batch simulator stepping blocks of battles in lockstep over
+        /// a `battle_soa`. Decisions are taken per lane; all stat mutations
+        /// run as lane kernels. Every lane owns its random stream, seeded
+        /// like `battle_simulator::run_batch` does: the same seed produces
+        /// the same battles.
+        class soa_battle_simulator
+        {
+        private:
+            sim_ritual_set _rituals;
+            int _max_turns{100};
+            sz_t _block_size{2048};
+
+            battle_soa _soa;
+            std::array<battle_op_lanes, battle_action_op_count> _ops;
+
+            void scatter(sz_t lane, const battle_action& a) noexcept
+            {
+                for(sz_t k(0); k < battle_action_op_count; ++k)
+                    _ops[k].add(lane, a._ops[k]);
+            }
+
+            void apply_ops()
+            {
+                for(auto& o : _ops) o.apply(_soa);
+            }
+
+            /// @brief Records the lanes whose battle ended and drops them,
+            /// so that later phases only step live battles.
+            void retire_finished(int turn, batch_result& result)
+            {
+                const auto ph(_soa.player(stat_type::health));
+                const auto eh(_soa.enemy(stat_type::health));
+
+                _soa.retain([&](sz_t i)
+                    {
+                        if(ph[i] > 0 && eh[i] > 0) return true;
+
+                        result.add({eh[i] <= 0, turn, ph[i], eh[i]});
+                        return false;
+                    });
+            }
+
+            void player_phase()
+            {
+                auto mana(_soa.player(stat_type::mana));
+
+                for(sz_t i(0); i < _soa.size(); ++i)
+                {
+                    auto& rng(_soa.rng(i));
+
+                    auto r(impl::choose_ritual(_rituals, mana[i], rng));
+                    if(r == nullptr) continue;
+
+                    mana[i] -= r->_spec._req_mana;
+
+                    if(rng.next_float() < r->_success_chance)
+                        scatter(i, r->_spec._action);
+                }
+
+                apply_ops();
+            }
+
+            // Stuns and buffs are not modelled: no ritual or AI decision
+            // produces one.
+            void enemy_phase(enemy_ai_fn ai)
+            {
+                for(sz_t i(0); i < _soa.size(); ++i)
+                {
+                    auto d(ai(_soa.player_stats(i), _soa.enemy_stats(i)));
+                    scatter(i, d._action);
+                }
+
+                apply_ops();
+            }
+
+            void run_block(const battle_t& battle, enemy_ai_fn ai,
+                rng_t::seed_type seed, sz_t first, sz_t n,
+                batch_result& result)
+            {
+                _soa.resize(n);
+                _soa.fill(battle, seed, first);
+                for(auto& o : _ops) o.resize(n);
+
+                int turn{0};
+
+                while(_soa.size() > 0 && turn < _max_turns)
+                {
+                    ++turn;
+
+                    player_phase();
+                    retire_finished(turn, result);
+                    if(_soa.size() == 0 || turn >= _max_turns) break;
+
+                    enemy_phase(ai);
+                    retire_finished(turn, result);
+                }
+
+                // Battles stopped by `_max_turns`.
+                const auto ph(_soa.player(stat_type::health));
+                const auto eh(_soa.enemy(stat_type::health));
+
+                for(sz_t i(0); i < _soa.size(); ++i)
+                    result.add({false, turn, ph[i], eh[i]});
+            }
+
+        public:
+            soa_battle_simulator(sim_ritual_set rituals = default_rituals())
+                : _rituals(std::move(rituals))
+            {
+            }
+
+            auto& rituals() noexcept { return _rituals; }
+            const auto& rituals() const noexcept { return _rituals; }
+
+            auto& max_turns() noexcept { return _max_turns; }
+            const auto& max_turns() const noexcept { return _max_turns; }
+
+            auto& block_size() noexcept { return _block_size; }
+            const auto& block_size() const noexcept { return _block_size; }
+
+            auto run_batch(const battle_t& battle, enemy_ai_fn ai, sz_t count,
+                rng_t::seed_type seed)
+            {
+                VRM_CORE_ASSERT_OP(_block_size, >, 0);
+
+                batch_result result;
+
+                for(sz_t i(0); i < count; i += _block_size)
+                {
+                    auto n(std::min(_block_size, count - i));
+                    run_block(battle, ai, seed, i, n, result);
+                }
+
+                return result;
+            }
+        };
+    }
+}
+GGJ16_NAMESPACE_END
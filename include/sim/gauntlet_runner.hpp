@@ -0,0 +1,165 @@
+#pragma once
+
+#include "base.hpp"
+
+#include "battle/stat.hpp"
+#include "battle/battle.hpp"
+#include "battle/gauntlet.hpp"
+#include "sim/battle_sim.hpp"
+#include "sim/work_stealing.hpp"
+
+GGJ16_NAMESPACE
+{
+    namespace sim
+    {
+        /// @brief Outcome distribution of the battles against one demon.
+        struct demon_histogram
+        {
+            static constexpr sz_t turn_bin_count{101};
+            static constexpr sz_t hp_bin_width{5};
+            static constexpr sz_t hp_bin_count{21};
+
+            sz_t _fought{0};
+            sz_t _wins{0};
+
+            /// @brief Turns needed to kill the demon, for won battles.
+            std::array<sz_t, turn_bin_count> _turns{};
+
+            /// @brief Player health left, in `hp_bin_width` bins, for won
+            /// battles.
+            std::array<sz_t, hp_bin_count> _hp_left{};
+
+            void add(const battle_result& r) noexcept
+            {
+                ++_fought;
+                if(!r._player_won) return;
+
+                ++_wins;
+
+                auto t(std::min(sz_t(r._turns), turn_bin_count - 1));
+                ++_turns[t];
+
+                auto h(std::max(r._player_health, 0.f) / hp_bin_width);
+                ++_hp_left[std::min(sz_t(h), hp_bin_count - 1)];
+            }
+
+            void merge(const demon_histogram& x) noexcept
+            {
+                _fought += x._fought;
+                _wins += x._wins;
+                for(sz_t i(0); i < turn_bin_count; ++i) _turns[i] += x._turns[i];
+                for(sz_t i(0); i < hp_bin_count; ++i) _hp_left[i] += x._hp_left[i];
+            }
+
+            auto win_rate() const noexcept
+            {
+                return _fought == 0 ? 0.0 : double(_wins) / _fought;
+            }
+
+            /// @brief Smallest turn count `t` such that at least `p` of the
+            /// won battles ended within `t` turns.
+            auto turns_percentile(double p) const noexcept
+            {
+                sz_t acc(0);
+                for(sz_t i(0); i < turn_bin_count; ++i)
+                {
+                    acc += _turns[i];
+                    if(acc >= p * _wins && acc > 0) return i;
+                }
+
+                return turn_bin_count - 1;
+            }
+        };
+
+        struct gauntlet_histogram
+        {
+            sz_t _playthroughs{0};
+            sz_t _completed{0};
+            std::array<demon_histogram, gauntlet::demon_count> _demons;
+
+            void merge(const gauntlet_histogram& x) noexcept
+            {
+                _playthroughs += x._playthroughs;
+                _completed += x._completed;
+                for(sz_t i(0); i < gauntlet::demon_count; ++i)
+                    _demons[i].merge(x._demons[i]);
+            }
+        };
+
+        /// @brief Monte Carlo runner for the four-demon gauntlet. Each
+        /// playthrough fights the demons in order until the player loses,
+        /// with a seed derived from its index only: results do not depend
+        /// on the thread count or on scheduling.
+        class gauntlet_runner
+        {
+        private:
+            // Padded to a cache line, to avoid false sharing between workers.
+            struct worker_state
+            {
+                gauntlet_histogram _histogram;
+                char _padding[64];
+            };
+
+            battle_simulator _simulator;
+            std::array<battle_t, gauntlet::demon_count> _battles{{
+                gauntlet::make_battle(0), gauntlet::make_battle(1),
+                gauntlet::make_battle(2), gauntlet::make_battle(3),
+            }};
+            sz_t _chunk_size{4096};
+
+            void playthrough(
+                gauntlet_histogram& h, rng_t::seed_type seed, sz_t idx) const
+            {
+                auto s(battle_seed(seed, idx));
+
+                ++h._playthroughs;
+
+                for(sz_t d(0); d < gauntlet::demon_count; ++d)
+                {
+                    auto r(_simulator.run(
+                        _battles[d], gauntlet::demon_ai(d), battle_seed(s, d)));
+                    h._demons[d].add(r);
+
+                    if(!r._player_won) return;
+                }
+
+                ++h._completed;
+            }
+
+        public:
+            auto& simulator() noexcept { return _simulator; }
+            const auto& simulator() const noexcept { return _simulator; }
+
+            /// @brief Initial state of the battle against demon `d`, which
+            /// can be tweaked to sweep demon stats.
+            auto& battle(sz_t d) noexcept { return _battles[d]; }
+            const auto& battle(sz_t d) const noexcept { return _battles[d]; }
+
+            auto& chunk_size() noexcept { return _chunk_size; }
+            const auto& chunk_size() const noexcept { return _chunk_size; }
+
+            auto run(work_stealing_pool& pool, sz_t playthroughs,
+                rng_t::seed_type seed) const
+            {
+                VRM_CORE_ASSERT_OP(_chunk_size, >, 0);
+
+                std::vector<worker_state> workers(pool.thread_count());
+                auto chunk_count((playthroughs + _chunk_size - 1) / _chunk_size);
+
+                pool.run(chunk_count, [&](sz_t w, sz_t chunk)
+                    {
+                        auto& h(workers[w]._histogram);
+                        auto b(chunk * _chunk_size);
+                        auto e(std::min(b + _chunk_size, playthroughs));
+
+                        for(auto i(b); i < e; ++i) playthrough(h, seed, i);
+                    });
+
+                gauntlet_histogram result;
+                for(const auto& w : workers) result.merge(w._histogram);
+                return result;
+            }
+        };
+    }
+}
+GGJ16_NAMESPACE_END
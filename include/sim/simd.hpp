@@ -0,0 +1,180 @@
+#pragma once
+
+#include "base.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define GGJ16_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GGJ16_SIMD_SSE2 1
+#endif
+
+GGJ16_NAMESPACE
+{
+    namespace sim
+    {
+        namespace simd
+        {
+            /// @brief One-lane fallback, also used for the tail of every
+            /// kernel loop.
+            struct scalar_ops
+            {
+                using type = float;
+                using mask_type = bool;
+                static constexpr sz_t width{1};
+
+                static auto load(const float* p) noexcept { return *p; }
+                static void store(float* p, type x) noexcept { *p = x; }
+                static auto set1(float x) noexcept { return x; }
+
+                static auto add(type a, type b) noexcept { return a + b; }
+                static auto sub(type a, type b) noexcept { return a - b; }
+                static auto mul(type a, type b) noexcept { return a * b; }
+                static auto div(type a, type b) noexcept { return a / b; }
+
+                // Same semantics as `ssvu::clampMin`/`ssvu::clampMax`.
+                static auto max(type a, type b) noexcept { return a < b ? b : a; }
+                static auto min(type a, type b) noexcept { return a > b ? b : a; }
+
+                static auto gt(type a, type b) noexcept { return a > b; }
+                static auto ne(type a, type b) noexcept { return a != b; }
+                static auto select(mask_type m, type a, type b) noexcept
+                {
+                    return m ? a : b;
+                }
+            };
+
+#if defined(GGJ16_SIMD_AVX)
+            struct wide_ops
+            {
+                using type = __m256;
+                using mask_type = __m256;
+                static constexpr sz_t width{8};
+
+                static auto load(const float* p) noexcept
+                {
+                    return _mm256_loadu_ps(p);
+                }
+                static void store(float* p, type x) noexcept
+                {
+                    _mm256_storeu_ps(p, x);
+                }
+                static auto set1(float x) noexcept { return _mm256_set1_ps(x); }
+
+                static auto add(type a, type b) noexcept
+                {
+                    return _mm256_add_ps(a, b);
+                }
+                static auto sub(type a, type b) noexcept
+                {
+                    return _mm256_sub_ps(a, b);
+                }
+                static auto mul(type a, type b) noexcept
+                {
+                    return _mm256_mul_ps(a, b);
+                }
+                static auto div(type a, type b) noexcept
+                {
+                    return _mm256_div_ps(a, b);
+                }
+                // `max_ps(x, y)` is `x > y ? x : y`: swapped operands
+                // match `scalar_ops` for NaN and signed zeros too.
+                static auto max(type a, type b) noexcept
+                {
+                    return _mm256_max_ps(b, a);
+                }
+                static auto min(type a, type b) noexcept
+                {
+                    return _mm256_min_ps(b, a);
+                }
+
+                static auto gt(type a, type b) noexcept
+                {
+                    return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+                }
+                static auto ne(type a, type b) noexcept
+                {
+                    return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ);
+                }
+                static auto select(mask_type m, type a, type b) noexcept
+                {
+                    return _mm256_blendv_ps(b, a, m);
+                }
+            };
+#elif defined(GGJ16_SIMD_SSE2)
+            struct wide_ops
+            {
+                using type = __m128;
+                using mask_type = __m128;
+                static constexpr sz_t width{4};
+
+                static auto load(const float* p) noexcept
+                {
+                    return _mm_loadu_ps(p);
+                }
+                static void store(float* p, type x) noexcept
+                {
+                    _mm_storeu_ps(p, x);
+                }
+                static auto set1(float x) noexcept { return _mm_set1_ps(x); }
+
+                static auto add(type a, type b) noexcept
+                {
+                    return _mm_add_ps(a, b);
+                }
+                static auto sub(type a, type b) noexcept
+                {
+                    return _mm_sub_ps(a, b);
+                }
+                static auto mul(type a, type b) noexcept
+                {
+                    return _mm_mul_ps(a, b);
+                }
+                static auto div(type a, type b) noexcept
+                {
+                    return _mm_div_ps(a, b);
+                }
+                // See the AVX `max` and `min`.
+                static auto max(type a, type b) noexcept
+                {
+                    return _mm_max_ps(b, a);
+                }
+                static auto min(type a, type b) noexcept
+                {
+                    return _mm_min_ps(b, a);
+                }
+
+                static auto gt(type a, type b) noexcept
+                {
+                    return _mm_cmpgt_ps(a, b);
+                }
+                static auto ne(type a, type b) noexcept
+                {
+                    return _mm_cmpneq_ps(a, b);
+                }
+                static auto select(mask_type m, type a, type b) noexcept
+                {
+                    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+                }
+            };
+#else
+            using wide_ops = scalar_ops;
+#endif
+
+            /// @brief Calls `f(ops, i)` for every lane block in `[0, n)`:
+            /// full `wide_ops` blocks first, then the scalar tail.
+            template <typename TF>
+            inline void for_lanes(sz_t n, TF&& f)
+            {
+                auto wide_n(n - n % wide_ops::width);
+                sz_t i(0);
+
+                for(; i < wide_n; i += wide_ops::width) f(wide_ops{}, i);
+                for(; i < n; ++i) f(scalar_ops{}, i);
+            }
+        }
+    }
+}
+GGJ16_NAMESPACE_END
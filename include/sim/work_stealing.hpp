@@ -0,0 +1,151 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "base.hpp"
+
+GGJ16_NAMESPACE
+{
+    namespace sim
+    {
+        /// @brief Runs `chunk_count` independent chunks of work on
+        /// `thread_count` workers. Every worker starts with an even slice of
+        /// the chunk range and pops chunks from its front; idle workers
+        /// steal the back half of a victim's remaining range. Ranges are
+        /// packed `[begin, end)` pairs in a single atomic word, so neither
+        /// popping nor stealing takes a lock.
+        class work_stealing_pool
+        {
+        private:
+            using range_word = std::uint64_t;
+
+            // Padded to a cache line, to avoid false sharing between workers.
+            struct worker_range
+            {
+                std::atomic<range_word> _range{0};
+                char _padding[64 - sizeof(std::atomic<range_word>)];
+            };
+
+            sz_t _thread_count;
+            std::unique_ptr<worker_range[]> _ranges;
+
+            static constexpr range_word pack(
+                std::uint32_t begin, std::uint32_t end) noexcept
+            {
+                return (range_word(begin) << 32) | end;
+            }
+
+            static constexpr std::uint32_t begin_of(range_word r) noexcept
+            {
+                return static_cast<std::uint32_t>(r >> 32);
+            }
+
+            static constexpr std::uint32_t end_of(range_word r) noexcept
+            {
+                return static_cast<std::uint32_t>(r);
+            }
+
+            /// @brief Pops one chunk from the front of `w`'s own range.
+            bool pop(sz_t w, std::uint32_t& chunk) noexcept
+            {
+                auto& a(_ranges[w]._range);
+                auto r(a.load(std::memory_order_relaxed));
+
+                while(begin_of(r) < end_of(r))
+                {
+                    if(a.compare_exchange_weak(r,
+                           pack(begin_of(r) + 1, end_of(r)),
+                           std::memory_order_acq_rel))
+                    {
+                        chunk = begin_of(r);
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            /// @brief Moves the back half of some victim's range into `w`'s
+            /// own (empty) range.
+            bool steal(sz_t w) noexcept
+            {
+                for(sz_t k(1); k < _thread_count; ++k)
+                {
+                    auto& a(_ranges[(w + k) % _thread_count]._range);
+                    auto r(a.load(std::memory_order_relaxed));
+
+                    while(begin_of(r) < end_of(r))
+                    {
+                        auto b(begin_of(r));
+                        auto e(end_of(r));
+                        auto mid(b + (e - b) / 2);
+
+                        if(a.compare_exchange_weak(
+                               r, pack(b, mid), std::memory_order_acq_rel))
+                        {
+                            _ranges[w]._range.store(
+                                pack(mid, e), std::memory_order_release);
+                            return true;
+                        }
+                    }
+                }
+
+                return false;
+            }
+
+            template <typename TF>
+            void work(sz_t w, TF& f)
+            {
+                std::uint32_t chunk;
+
+                do
+                {
+                    while(pop(w, chunk)) f(w, sz_t(chunk));
+                } while(steal(w));
+            }
+
+        public:
+            work_stealing_pool(
+                sz_t thread_count = std::thread::hardware_concurrency())
+                : _thread_count{std::max(sz_t(1), thread_count)},
+                  _ranges{std::make_unique<worker_range[]>(_thread_count)}
+            {
+            }
+
+            const auto& thread_count() const noexcept { return _thread_count; }
+
+            /// @brief Calls `f(worker_index, chunk_index)` once for every
+            /// chunk in `[0, chunk_count)`, then returns. The calling thread
+            /// acts as worker `0`.
+            template <typename TF>
+            void run(sz_t chunk_count, TF&& f)
+            {
+                VRM_CORE_ASSERT_OP(chunk_count, <=, 0xFFFFFFFFu);
+
+                for(sz_t w(0); w < _thread_count; ++w)
+                {
+                    auto b(chunk_count * w / _thread_count);
+                    auto e(chunk_count * (w + 1) / _thread_count);
+
+                    _ranges[w]._range.store(
+                        pack(std::uint32_t(b), std::uint32_t(e)),
+                        std::memory_order_relaxed);
+                }
+
+                std::vector<std::thread> threads;
+                threads.reserve(_thread_count - 1);
+
+                for(sz_t w(1); w < _thread_count; ++w)
+                    threads.emplace_back([this, w, &f]
+                        {
+                            work(w, f);
+                        });
+
+                work(0, f);
+                for(auto& t : threads) t.join();
+            }
+        };
+    }
+}
+GGJ16_NAMESPACE_END
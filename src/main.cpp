@@ -1,9 +1,12 @@
 #include <iostream>
+#include <random>
+#include <tuple>
 
 #include "base.hpp"
 #include "game.hpp"
 #include "assets.hpp"
 #include "battle.hpp"
+#include "sim/battle_sim.hpp"
 
 // Battle system process:
 // 1. Every party member selects a ritual
@@ -32,12 +35,6 @@ GGJ16_NAMESPACE
         invalid
     };
 
-    enum class ritual_type
-    {
-        resist,
-        complete
-    };
-
     class battle_ritual_context;
 
     namespace impl
@@ -93,15 +90,6 @@ GGJ16_NAMESPACE
         };
     }
 
-    using ritual_uptr = std::unique_ptr<impl::ritual_minigame_base>;
-
-    struct symbol_point
-    {
-        vec2f _p;
-        float _radius{6.f};
-    };
-
-
     class symbol_ritual : public impl::ritual_minigame_base
     {
     private:
@@ -110,63 +98,64 @@ GGJ16_NAMESPACE
         int next_id{1};
         vec2f _center{
             game_constants::width / 2.f, game_constants::height / 2.f};
-        std::vector<sf::CircleShape> _pshapes;
-        std::vector<ssvs::BitmapText> _ptexts;
-        std::vector<int> _phits;
+        // State: `1` once hit.
+        circle_store _points{2.f, sfc::Black};
 
-        auto is_shape_hovered(const sf::CircleShape& cs) noexcept
-        {
-            auto mp(app().mp());
-            return ssvs::getDistEuclidean(mp, cs.getPosition()) <
-                   cs.getRadius();
-        }
+        // Only the first `_text_count` labels are in use: the others are
+        // kept for later casts.
+        std::vector<glyph_run> _ptexts;
+        sz_t _text_count{0};
 
-        auto all_hit_before(int i)
-        {
-            for(int j = 0; j < i; ++j)
-            {
-                if(_phits[j] == 0) return false;
-            }
-            return true;
-        }
+        // Points are hit in order: every point before `_next` is hit.
+        sz_t _next{0};
 
-        auto all_hit() const noexcept
+        auto is_point_hovered(sz_t i, const vec2f& mp) const noexcept
         {
-            for(const auto& h : _phits)
-            {
-                if(h == 0) return false;
-            }
-            return true;
+            return ssvs::getDistEuclidean(mp, _points.positions()[i]) <
+                   _points.radii()[i];
         }
 
+        auto all_hit() const noexcept { return _next == _points.size(); }
+
     public:
-        void add_point(const symbol_point& sp)
+        void add_point(const ritual_point& sp)
         {
             // Add shape
-            _pshapes.emplace_back();
-            auto& s(_pshapes.back());
-            s.setFillColor(sfc::Red);
-            s.setOutlineThickness(2);
-            s.setOutlineColor(sfc::Black);
-            s.setRadius(sp._radius * 2.8f);
-            ssvs::setOrigin(s, ssvs::getLocalCenter);
-            s.setPosition(_center + sp._p);
+            auto i(_points.add(
+                _center + sp._offset, sp._radius * 2.8f, sfc::Red));
 
             // Add text
-            _ptexts.emplace_back(mkTxtOBSmall());
-            auto& t(_ptexts.back());
-            t.setString(std::to_string(next_id++));
+            if(_text_count == _ptexts.size())
+                _ptexts.emplace_back(*assets().fontObStroked, -3);
+
+            auto& t(_ptexts[_text_count++]);
+            t.set_string(std::to_string(next_id++));
             t.setScale(vec2f(3.f, 3.f));
-            ssvs::setOrigin(t, ssvs::getLocalCenter);
-            t.setPosition(s.getPosition());
+            t.center_origin();
+            t.setPosition(_points.positions()[i]);
+        }
+
+        void add_points(const std::vector<ritual_point>& points)
+        {
+            _points.reserve(points.size());
+            _ptexts.reserve(points.size());
 
-            // Add hit
-            _phits.emplace_back(0);
+            for(const auto& p : points) add_point(p);
+        }
+
+        /// @brief Removes every point, keeping storage for the next cast.
+        void reset()
+        {
+            next_id = 1;
+            _points.clear();
+            _text_count = 0;
+            _next = 0;
         }
 
         void update(ft dt) override
         {
             base_type::update(dt);
+            _points.store_previous();
 
             if(all_hit())
             {
@@ -174,41 +163,34 @@ GGJ16_NAMESPACE
                 return;
             }
 
-            for(sz_t i = 0; i < _pshapes.size(); ++i)
+            // Only the next point can be hit; overlapping ones chain.
+            const auto& mp(app().mp());
+            while(_next < _points.size() && is_point_hovered(_next, mp))
             {
-                auto& s(_pshapes[i]);
-                auto& t(_ptexts[i]);
-                auto& h(_phits[i]);
-
-                if(all_hit_before(i) && is_shape_hovered(s))
-                {
-                    if(h == 0)
-                    {
-                        assets().psnd(assets().blip);
-                        h = 1;
-                    }
-                }
+                assets().psnd(assets().blip);
+                _points.states()[_next] = 1;
+                _points.fills()[_next] = sfc::Green;
+                _ptexts[_next].set_string("");
+                ++_next;
+            }
 
-                if(h == 1)
-                {
-                    s.setFillColor(sfc::Green);
-                    t.setString("");
-                    ssvs::setOrigin(s, ssvs::getLocalCenter);
-                    s.setRadius(std::max(0.f, std::abs(s.getRadius() - (dt))));
-                }
+            // Hit points shrink away.
+            auto& radii(_points.radii());
+            for(sz_t i = 0; i < _next; ++i)
+            {
+                radii[i] = std::max(0.f, std::abs(radii[i] - dt));
             }
         }
         void draw() override
         {
-            for(auto& s : _pshapes)
-            {
-                app().render(s);
-            }
+            _points.add_to(app().batch(), app().sim_alpha());
 
-            for(auto& t : _ptexts)
+            for(sz_t i = 0; i < _text_count; ++i)
             {
-                app().render(t);
+                _ptexts[i].add_to(app().batch());
             }
+
+            app().flush_batch();
         }
     };
 
@@ -219,40 +201,54 @@ GGJ16_NAMESPACE
 
         vec2f _center{
             game_constants::width / 2.f, game_constants::height / 2.f};
-        std::vector<sf::CircleShape> _pshapes;
+        // State: `1` while hovered.
+        circle_store _points{3.f, sfc::Black};
+
+        // Points never move and grow up to a radius of 75, so the grid is
+        // built once with that bound and refined on query.
+        hit_grid _grid{vec2f(game_constants::width, game_constants::height)};
 
-        auto is_shape_hovered(const sf::CircleShape& cs) noexcept
+        auto is_point_hovered(sz_t i, const vec2f& mp) const noexcept
         {
-            auto mp(app().mp());
-            return ssvs::getDistEuclidean(mp, cs.getPosition()) <
-                   cs.getRadius();
+            return ssvs::getDistEuclidean(mp, _points.positions()[i]) <
+                   _points.radii()[i];
         }
 
         auto any_dead() const noexcept
         {
-            for(const auto& c : _pshapes)
-                if(c.getRadius() < 5.f) return true;
+            for(auto r : _points.radii())
+                if(r < 5.f) return true;
 
             return false;
         }
 
     public:
-        void add_point(const symbol_point& sp)
+        void add_point(const ritual_point& sp)
         {
             // Add shape
-            _pshapes.emplace_back();
-            auto& s(_pshapes.back());
-            s.setFillColor(sfc::Red);
-            s.setOutlineThickness(3);
-            s.setOutlineColor(sfc::Black);
-            s.setRadius(sp._radius * 3.1f);
-            ssvs::setOrigin(s, ssvs::getLocalCenter);
-            s.setPosition(_center + sp._p);
+            auto radius(sp._radius * 3.1f);
+            auto i(_points.add(_center + sp._offset, radius, sfc::Red));
+
+            _grid.add(i, _points.positions()[i], std::max(75.f, radius));
+        }
+
+        void add_points(const std::vector<ritual_point>& points)
+        {
+            _points.reserve(points.size());
+            for(const auto& p : points) add_point(p);
+        }
+
+        /// @brief Removes every point, keeping storage for the next cast.
+        void reset()
+        {
+            _points.clear();
+            _grid.clear();
         }
 
         void update(ft dt) override
         {
             base_type::update(dt);
+            _points.store_previous();
 
             if(any_dead())
             {
@@ -261,39 +257,42 @@ GGJ16_NAMESPACE
 
             bool mps{false};
 
-            for(sz_t i = 0; i < _pshapes.size(); ++i)
-            {
-                auto& s(_pshapes[i]);
-
-                ssvs::setOrigin(s, ssvs::getLocalCenter);
+            const auto& mp(app().mp());
+            auto& hovered(_points.states());
+            std::fill(std::begin(hovered), std::end(hovered), 0);
+            _grid.for_hits(mp, [this, &mp, &hovered](sz_t i)
+                {
+                    hovered[i] = is_point_hovered(i, mp);
+                });
 
+            auto& radii(_points.radii());
+            auto& fills(_points.fills());
 
-                if(is_shape_hovered(s))
+            for(sz_t i = 0; i < _points.size(); ++i)
+            {
+                if(hovered[i])
                 {
                     mps = true;
-                    s.setFillColor(sfc::Green);
-                    s.setRadius(
-                        std::min(75.f, std::abs(s.getRadius() + dt * 2.78f)));
+                    fills[i] = sfc::Green;
+                    radii[i] = std::min(75.f, std::abs(radii[i] + dt * 2.78f));
                 }
                 else
                 {
-                    s.setFillColor(sfc::Red);
-                    s.setRadius(
-                        std::max(0.f, std::abs(s.getRadius() - (dt * 0.74f))));
+                    fills[i] = sfc::Red;
+                    radii[i] =
+                        std::max(0.f, std::abs(radii[i] - (dt * 0.74f)));
                 }
             }
 
             if(mps)
             {
-                assets().psnd(assets().bip);
+                assets().psnd(assets().bip, sound_priority::low);
             }
         }
         void draw() override
         {
-            for(auto& s : _pshapes)
-            {
-                app().render(s);
-            }
+            _points.add_to(app().batch(), app().sim_alpha());
+            app().flush_batch();
         }
     };
 
@@ -307,42 +306,31 @@ GGJ16_NAMESPACE
         vec2f _center{
             game_constants::width / 2.f, game_constants::height / 2.f};
 
+        // Only the first `_target_count` targets are in use: the others
+        // are kept for later casts.
         std::vector<sf::RectangleShape> _ptargets;
-        std::vector<int> _phits;
-        std::vector<sf::CircleShape> _pdraggables;
+        sz_t _target_count{0};
         int _curr = -1;
 
+        // Every target spins together, interpolated when drawn.
+        float _target_rotation{0.f}, _prev_target_rotation{0.f};
 
-        auto is_shape_hovered(const sf::RectangleShape& cs) noexcept
-        {
-            auto mp(app().mp());
-
-            if(mp.x < ssvs::getGlobalLeft(cs)) return false;
-            if(mp.x > ssvs::getGlobalRight(cs)) return false;
+        // State: `1` once landed on a target.
+        circle_store _draggables{4.f, sfc::Black};
 
-            if(mp.y < ssvs::getGlobalTop(cs)) return false;
-            if(mp.y > ssvs::getGlobalBottom(cs)) return false;
-
-            return true;
-        }
-
-        auto is_shape_hovered(const sf::CircleShape& cs) noexcept
-        {
-            auto mp(app().mp());
-            return ssvs::getDistEuclidean(mp, cs.getPosition()) <
-                   cs.getRadius();
-        }
+        // A draggable lands when its center is this close to a target's.
+        static constexpr float target_radius{20.f * 3.f};
 
-        auto is_in_target(
-            const sf::CircleShape& cs, const sf::RectangleShape rs)
-        {
-            return ssvs::getDistEuclidean(cs.getPosition(), rs.getPosition()) <
-                   20.f * 3.f;
-        }
+        // Only the dragged shape ever moves, and it is never picked again
+        // once it lands, so neither grid needs rebuilding while playing.
+        hit_grid _draggable_grid{
+            vec2f(game_constants::width, game_constants::height)};
+        hit_grid _target_grid{
+            vec2f(game_constants::width, game_constants::height)};
 
         auto all_hit() const noexcept
         {
-            for(const auto& x : _phits)
+            for(const auto& x : _draggables.states())
                 if(x == 0) return false;
             return true;
         }
@@ -351,8 +339,9 @@ GGJ16_NAMESPACE
     public:
         void add_target(vec2f p)
         {
-            _ptargets.emplace_back();
-            auto& t(_ptargets.back());
+            if(_target_count == _ptargets.size()) _ptargets.emplace_back();
+
+            auto& t(_ptargets[_target_count++]);
 
             t.setFillColor(sfc::Black);
             t.setOutlineColor(sfc::White);
@@ -360,25 +349,50 @@ GGJ16_NAMESPACE
             t.setSize(vec2f(26 * 3.f, 26 * 3.f));
             ssvs::setOrigin(t, ssvs::getLocalCenter);
             t.setPosition(p);
+
+            _target_grid.add(_target_count - 1, p, target_radius);
         }
 
         void add_draggable(vec2f p)
         {
-            _pdraggables.emplace_back();
-            _phits.emplace_back(0);
-            auto& t(_pdraggables.back());
+            auto radius(7.f * 3.f);
+            auto i(_draggables.add(p, radius, sfc::Red));
 
-            t.setFillColor(sfc::Red);
-            t.setOutlineColor(sfc::Black);
-            t.setOutlineThickness(4.f);
-            t.setRadius(7.f * 3.f);
-            ssvs::setOrigin(t, ssvs::getLocalCenter);
-            t.setPosition(p);
+            _draggable_grid.add(i, p, radius);
+        }
+
+        /// @brief Adds the targets and draggables of `d`. Scattered
+        /// draggables are placed with `rng`.
+        void add_from(const ritual_def& d, rng_t& rng)
+        {
+            for(const auto& p : d._targets) add_target(_center + p);
+            for(const auto& p : d._draggables) add_draggable(_center + p);
+
+            auto margin(d._scatter._margin);
+            for(sz_t i(0); i < d._scatter._count; ++i)
+            {
+                auto x(rng.range(margin, game_constants::width - margin));
+                auto y(rng.range(margin, game_constants::height - margin));
+                add_draggable(vec2f{x, y});
+            }
+        }
+
+        /// @brief Removes every target and draggable, keeping storage for
+        /// the next cast.
+        void reset()
+        {
+            _target_count = 0;
+            _curr = -1;
+            _target_rotation = _prev_target_rotation = 0.f;
+            _draggables.clear();
+            _draggable_grid.clear();
+            _target_grid.clear();
         }
 
         void update(ft dt) override
         {
             base_type::update(dt);
+            _draggables.store_previous();
 
             if(all_hit())
             {
@@ -386,62 +400,86 @@ GGJ16_NAMESPACE
             }
 
 
-            if(_curr != -1 && _phits[_curr] == 1)
+            auto& hits(_draggables.states());
+
+            if(_curr != -1 && hits[_curr] == 1)
             {
                 _curr = -1;
             }
 
-            for(int i = 0; i < (int)_pdraggables.size(); ++i)
+            const auto& mp(app().mp());
+
+            if(_curr == -1)
             {
-                auto& s(_pdraggables[i]);
-                ssvs::setOrigin(s, ssvs::getLocalCenter);
+                _draggable_grid.for_hits(mp, [this, &hits](sz_t i)
+                    {
+                        if(_curr != -1 || hits[i] != 0) return;
 
-                if(_phits[i] == 0 && is_shape_hovered(s) && _curr == -1)
-                {
-                    s.setFillColor(sfc::Green);
-                    _curr = i;
-                    assets().psnd(assets().bip);
-                }
+                        _draggables.fills()[i] = sfc::Green;
+                        _curr = i;
+                        assets().psnd(assets().bip, sound_priority::low);
+                    });
+            }
 
-                if(_curr == i && _phits[i] == 0)
-                {
-                    auto mp(app().mp());
-                    s.setPosition(vec2f(mp));
-                }
+            auto& positions(_draggables.positions());
 
-                for(auto& t : _ptargets)
-                {
-                    if(is_in_target(s, t) && _phits[i] == 0)
+            for(int i = 0; i < (int)_draggables.size(); ++i)
+            {
+                if(hits[i] != 0) continue;
+                if(_curr == i) positions[i] = mp;
+
+                _target_grid.for_hits(positions[i], [this, i, &hits](sz_t)
                     {
-                        s.setRadius(0.f);
-                        _phits[i] = 1;
+                        if(hits[i] != 0) return;
+
+                        _draggables.radii()[i] = 0.f;
+                        hits[i] = 1;
                         assets().psnd(assets().blip);
 
                         if(_curr == i)
                         {
                             _curr = -1;
                         }
-                    }
-                }
+                    });
             }
 
-            for(auto& t : _ptargets)
-            {
-                t.setRotation(t.getRotation() + dt * 0.5f);
-            }
+            _prev_target_rotation = _target_rotation;
+            _target_rotation += dt * 0.5f;
         }
 
         void draw() override
         {
-            for(auto& s : _ptargets)
-            {
-                app().render(s);
-            }
+            auto alpha(app().sim_alpha());
+            auto rotation(_prev_target_rotation +
+                          (_target_rotation - _prev_target_rotation) * alpha);
 
-            for(auto& s : _pdraggables)
+            for(sz_t i = 0; i < _target_count; ++i)
             {
-                app().render(s);
+                _ptargets[i].setRotation(rotation);
+                app().batch().add(_ptargets[i]);
             }
+
+            _draggables.add_to(app().batch(), alpha);
+            app().flush_batch();
+        }
+    };
+
+    /// @brief One instance of every minigame type, reused by every cast:
+    /// only one ritual is played at a time. Instances keep their storage
+    /// between casts, so casting allocates nothing once warmed up.
+    class ritual_pool
+    {
+    private:
+        std::tuple<symbol_ritual, aura_ritual, drag_ritual> _minigames;
+
+    public:
+        /// @brief The instance of `T`, reset for a new cast.
+        template <typename T>
+        auto& acquire()
+        {
+            auto& result(std::get<T>(_minigames));
+            result.reset();
+            return result;
         }
     };
 
@@ -449,51 +487,89 @@ GGJ16_NAMESPACE
 
     using ritual_effect_fn = std::function<void(battle_context_t&)>;
 
+    /// @brief Casts the ritual of a catalogue entry, which must outlive
+    /// it. Pooled minigames are filled from the entry's precomputed tables.
     class ritual_maker
     {
     private:
-        std::string _label;
+        const ritual_def* _def;
         std::string _desc;
-        ritual_type _type;
-        float _time;
-        float _req_mana{0};
-        std::function<ritual_uptr()> _fn_make;
-        ritual_effect_fn _fn_effect;
 
     public:
-        template <typename TF0, typename TF1>
-        ritual_maker(const std::string& label, const std::string& desc,
-            ritual_type type, float time, float req_mana, TF0&& f, TF1&& f_eff)
-            : _label{label}, _desc{desc}, _type{type}, _time{time},
-              _req_mana{req_mana}, _fn_make(f), _fn_effect(f_eff)
+        ritual_maker(const ritual_def& d) : _def{&d}
         {
+            std::ostringstream oss;
+            oss << d._desc << "\nTime: " << d._time
+                << "\tMana: " << d._req_mana;
+            _desc = oss.str();
         }
 
-        const auto& type() const noexcept { return _type; }
-        const auto& time() const noexcept { return _time; }
-        const auto& label() const noexcept { return _label; }
-        auto desc() const noexcept
+        const auto& id() const noexcept { return _def->_id; }
+        const auto& type() const noexcept { return _def->_type; }
+        const auto& time() const noexcept { return _def->_time; }
+        const auto& label() const noexcept { return _def->_label; }
+        const auto& desc() const noexcept { return _desc; }
+        const auto& req_mana() const noexcept { return _def->_req_mana; }
+
+        impl::ritual_minigame_base& make(
+            ritual_pool& pool, rng_t& rng) const
         {
-            std::ostringstream oss;
-            oss << _desc << "\nTime: " << _time << "\tMana: " << _req_mana;
-            return oss.str();
+            impl::ritual_minigame_base* result{nullptr};
+
+            switch(_def->_minigame)
+            {
+                case ritual_minigame_kind::symbol:
+                {
+                    auto& r(pool.acquire<symbol_ritual>());
+                    r.add_points(_def->_points);
+                    result = &r;
+                    break;
+                }
+                case ritual_minigame_kind::aura:
+                {
+                    auto& r(pool.acquire<aura_ritual>());
+                    r.add_points(_def->_points);
+                    result = &r;
+                    break;
+                }
+                case ritual_minigame_kind::drag:
+                {
+                    auto& r(pool.acquire<drag_ritual>());
+                    r.add_from(*_def, rng);
+                    result = &r;
+                    break;
+                }
+            }
+
+            VRM_CORE_ASSERT(result != nullptr);
+            result->_type = _def->_type;
+            return *result;
         }
 
-        auto& req_mana() noexcept { return _req_mana; }
-        const auto& req_mana() const noexcept { return _req_mana; }
+        ritual_effect_fn effect() const
+        {
+            return [d = _def](battle_context_t& c)
+            {
+                if(!d->_sound.empty())
+                    assets().psnd(
+                        assets().sound(d->_sound), sound_priority::high);
 
-        auto make() { return _fn_make(); }
-        auto& effect() { return _fn_effect; }
+                apply_battle_action(c, d->_action);
+            };
+        }
     };
 
     class battle_screen;
 
     struct cenemy_state
     {
-        sf::Texture* _enemy_texture;
-        std::function<void(battle_screen&, battle_context_t&)> _f_ai;
+        texture_region _enemy_region;
+        enemy_ai_fn _f_ai;
 
-        cenemy_state(sf::Texture* t) : _enemy_texture(t) {}
+        cenemy_state(const texture_region& r, enemy_ai_fn f_ai)
+            : _enemy_region(r), _f_ai{f_ai}
+        {
+        }
     };
 
     class cplayer_state
@@ -505,59 +581,16 @@ GGJ16_NAMESPACE
         // vector of available items
 
     public:
-        cplayer_state()
-        {
-            _atk_rituals.reserve(3);
-            _utl_rituals.reserve(3);
-            _mana_rituals.reserve(1);
-        }
-
-        template <typename T, typename TF0, typename TF1, typename... Ts>
-        void emplace_atk_ritual(const std::string& label,
-            const std::string& desc, ritual_type rt, float time, float req_mana,
-            TF0&& f_init, TF1&& f_effect)
-        {
-            _atk_rituals.emplace_back(label, desc, rt, time, req_mana,
-                [f_init, rt]
-                {
-                    auto uptr(std::make_unique<T>());
-                    uptr->_type = rt;
-                    f_init(*uptr);
-                    return uptr;
-                },
-                f_effect);
-        }
-
-        template <typename T, typename TF0, typename TF1, typename... Ts>
-        void emplace_utl_ritual(const std::string& label,
-            const std::string& desc, ritual_type rt, float time, float req_mana,
-            TF0&& f_init, TF1&& f_effect)
-        {
-            _utl_rituals.emplace_back(label, desc, rt, time, req_mana,
-                [f_init, rt]
-                {
-                    auto uptr(std::make_unique<T>());
-                    uptr->_type = rt;
-                    f_init(*uptr);
-                    return uptr;
-                },
-                f_effect);
-        }
-
-        template <typename T, typename TF0, typename TF1, typename... Ts>
-        void emplace_mana_ritual(const std::string& label,
-            const std::string& desc, ritual_type rt, float time, float req_mana,
-            TF0&& f_init, TF1&& f_effect)
+        /// @brief Adds the ritual of `d` to its menu. `d` must outlive
+        /// this state.
+        void add_ritual(const ritual_def& d)
         {
-            _mana_rituals.emplace_back(label, desc, rt, time, req_mana,
-                [f_init, rt]
-                {
-                    auto uptr(std::make_unique<T>());
-                    uptr->_type = rt;
-                    f_init(*uptr);
-                    return uptr;
-                },
-                f_effect);
+            switch(d._menu)
+            {
+                case ritual_menu::attack: _atk_rituals.emplace_back(d); break;
+                case ritual_menu::utility: _utl_rituals.emplace_back(d); break;
+                case ritual_menu::mana: _mana_rituals.emplace_back(d); break;
+            }
         }
 
         template <typename TF>
@@ -584,9 +617,13 @@ GGJ16_NAMESPACE
     {
     private:
         game_app& _app;
-        std::unique_ptr<impl::ritual_minigame_base> _minigame{nullptr};
+
+        // Minigames are owned by the pool and reused across casts.
+        ritual_pool _pool;
+        impl::ritual_minigame_base* _minigame{nullptr};
         ssvs::BitmapTextRich _tr{*assets().fontObStroked};
         ssvs::BTR::PtrChunk _ptr_time_text;
+        int _shown_seconds{-1};
 
         auto valid() const noexcept
         {
@@ -611,6 +648,7 @@ GGJ16_NAMESPACE
 
     public:
         auto& app() noexcept { return _app; }
+        auto& pool() noexcept { return _pool; }
 
         battle_ritual_context(game_app& app) : _app(app) { init_text(); }
 
@@ -632,20 +670,29 @@ GGJ16_NAMESPACE
             return _minigame->state() == ritual_minigame_state::success;
         }
 
-        template <typename T>
-        void set_and_start_minigame(float time_as_ft, T&& x)
+        void set_and_start_minigame(
+            float time_as_ft, impl::ritual_minigame_base& x)
         {
-            _minigame = std::move(x);
+            _minigame = &x;
             _minigame->start_minigame(time_as_ft);
             _minigame->_ctx = this;
+            _shown_seconds = -1;
         }
 
         void update(ft dt)
         {
+            GGJ16_PROFILE_SCOPE("battle_ritual_context::update");
             VRM_CORE_ASSERT(valid());
 
-            _ptr_time_text->setStr(std::to_string(
-                vrmc::to_int(ssvu::getFTToSeconds(_minigame->time_left()))));
+            // The text only changes once per second.
+            auto seconds(
+                vrmc::to_int(ssvu::getFTToSeconds(_minigame->time_left())));
+
+            if(seconds != _shown_seconds)
+            {
+                _shown_seconds = seconds;
+                _ptr_time_text->setStr(std::to_string(seconds));
+            }
 
             _tr.update(dt);
             _minigame->update(dt);
@@ -743,12 +790,15 @@ GGJ16_NAMESPACE
         }
     };
 
-    class stat_bar : public sf::Transformable, public sf::Drawable
+    class stat_bar : public sf::Transformable
     {
     private:
-        ssvs::BitmapText _txt{mkTxtOBSmall()};
+        glyph_run _txt{*assets().fontObStroked, -3};
         sf::RectangleShape _bar, _bar_outl;
 
+        // Last refreshed values.
+        float _value{-1.f}, _maxvalue{-1.f};
+
         static constexpr float _bar_h{40.f};
         static constexpr float _bar_w_max{200.f};
 
@@ -766,28 +816,40 @@ GGJ16_NAMESPACE
             _txt.setScale(vec2f(3.f, 3.f));
         }
 
+        /// @brief Does nothing unless the displayed values changed.
         void refresh(float value, float maxvalue)
         {
+            GGJ16_PROFILE_SCOPE("stat_bar::refresh");
+
+            if(value == _value && maxvalue == _maxvalue) return;
+
+            auto text_changed(
+                (int)value != (int)_value || (int)maxvalue != (int)_maxvalue);
+
+            _value = value;
+            _maxvalue = maxvalue;
+
             auto width(value / maxvalue * _bar_w_max);
             _bar.setSize(vec2f(width, _bar_h));
             _bar_outl.setSize(vec2f(_bar_w_max, _bar_h));
 
-            _txt.setString(std::to_string((int)value) + std::string{" / "} +
-                           std::to_string((int)maxvalue));
+            if(!text_changed) return;
+
+            _txt.set_string(std::to_string((int)value) + std::string{" / "} +
+                            std::to_string((int)maxvalue));
             _txt.setPosition(_bar.getPosition());
         }
 
-        virtual void draw(
-            sf::RenderTarget& target, sf::RenderStates states) const override
+        void add_to(batch_renderer& b, sf::Transform t) const
         {
-            states.transform *= getTransform();
-            target.draw(_bar_outl, states);
-            target.draw(_bar, states);
-            target.draw(_txt, states);
+            t *= getTransform();
+            b.add(_bar_outl, t);
+            b.add(_bar, t);
+            _txt.add_to(b, t);
         }
     };
 
-    struct stats_gfx : public sf::Transformable, public sf::Drawable
+    struct stats_gfx : public sf::Transformable
     {
         stat_bar _health_b{sf::Color{255, 0, 0, 200}};
         stat_bar _shield_b{sf::Color{255, 255, 0, 200}};
@@ -800,20 +862,34 @@ GGJ16_NAMESPACE
             _mana_b.setPosition(0, 60.f);
         }
 
-        virtual void draw(
-            sf::RenderTarget& target, sf::RenderStates states) const override
+        /// @brief Bar texts are glyph quads, batched on top of the shapes.
+        void add_to(batch_renderer& b) const
         {
-            states.transform *= getTransform();
-            target.draw(_health_b, states);
-            target.draw(_shield_b, states);
-            if(_mana_visibile) target.draw(_mana_b, states);
+            _health_b.add_to(b, getTransform());
+            _shield_b.add_to(b, getTransform());
+            if(_mana_visibile) _mana_b.add_to(b, getTransform());
+        }
+
+        void refresh_health(const character_stats& cs)
+        {
+            _health_b.refresh(cs.eff_health(), cs.eff_maxhealth());
+        }
+
+        void refresh_shield(const character_stats& cs)
+        {
+            _shield_b.refresh(cs.eff_shield(), cs.eff_maxshield());
+        }
+
+        void refresh_mana(const character_stats& cs)
+        {
+            _mana_b.refresh(cs.eff_mana(), cs.eff_maxmana());
         }
 
         void refresh(const character_stats& cs)
         {
-            _health_b.refresh(cs.health(), cs.maxhealth());
-            _shield_b.refresh(cs.shield(), cs.maxshield());
-            _mana_b.refresh(cs.mana(), cs.maxmana());
+            refresh_health(cs);
+            refresh_shield(cs);
+            refresh_mana(cs);
         }
 
         void hide_mana()
@@ -841,9 +917,9 @@ GGJ16_NAMESPACE
             }
         };
 
-        sf::Sprite _landscape{*assets().landscape};
+        sf::Sprite _landscape{assets().landscape.make_sprite()};
         sf::Sprite _enemy;
-        sf::Sprite _bar{*assets().bar};
+        sf::Sprite _bar{assets().bar.make_sprite()};
 
         float _enemy_f{0};
         float _enemy_f_magnitude{30.f};
@@ -876,12 +952,18 @@ GGJ16_NAMESPACE
         ssvs::BTR::PtrWave _ptr_t_cs_wave;
 
         ritual_effect_fn _success_effect;
+        ritual_id _ritual_id{0};
 
+        battle_log::writer& _log;
+
+        // `dropped()` count of the event queue at the last drain.
+        sz_t _seen_dropped{0};
 
         void reset()
         {
             _state = battle_screen_state::player_menu;
             _ctx_idx = 0;
+            update_stat_bars();
         }
 
         stats_gfx _player_stats_gfx;
@@ -901,7 +983,7 @@ GGJ16_NAMESPACE
             _enemy_stats_gfx.setPosition(vec2f{20.f, 20.f});
             _enemy_stats_gfx.hide_mana();
 
-            _enemy.setTexture(*curr_bctx().enemy_state()._enemy_texture);
+            curr_bctx().enemy_state()._enemy_region.apply_to(_enemy);
             _enemy.setScale(vec2f(0.5f, 0.5f));
             ssvs::setOrigin(_enemy, ssvs::getLocalCenter);
             _esprite_pos = vec2f(game_constants::width / 2.f,
@@ -976,8 +1058,58 @@ GGJ16_NAMESPACE
                 });
         }
 
-        void game_over() { _state = battle_screen_state::to_game_over; }
-        void success() { _state = battle_screen_state::to_next_ctx; }
+        /// @brief Marks events lost since the last drain in the log.
+        /// Returns `true` if there were any.
+        bool log_dropped_events()
+        {
+            auto& q(curr_bctx().events());
+            if(q.dropped() == _seen_dropped) return false;
+
+            _log.dropped(q.dropped() - _seen_dropped);
+            _seen_dropped = q.dropped();
+            return true;
+        }
+
+        void drain_events()
+        {
+            auto& q(curr_bctx().events());
+
+            // Refresh everything if events were lost since the last drain.
+            if(log_dropped_events()) update_stat_bars();
+
+            q.drain([this](const battle_event& e)
+                {
+                    _log.event(e);
+                    this->refresh_stat_bar(e);
+                    this->event_listener(e);
+                });
+        }
+
+        void begin_battle_log() { _log.begin(curr_bctx()); }
+
+        void end_battle_log()
+        {
+            drain_events();
+            _log.end(curr_bctx());
+        }
+
+        void start_player_turn()
+        {
+            curr_bctx().battle().advance_turn();
+            _state = battle_screen_state::player_menu;
+        }
+
+        void game_over()
+        {
+            end_battle_log();
+            _state = battle_screen_state::to_game_over;
+        }
+
+        void success()
+        {
+            end_battle_log();
+            _state = battle_screen_state::to_next_ctx;
+        }
 
         void start_enemy_turn()
         {
@@ -989,15 +1121,19 @@ GGJ16_NAMESPACE
             _state = battle_screen_state::before_player_turn;
         }
 
-        void execute_ritual(ritual_maker rm)
+        void execute_ritual(const ritual_maker& rm)
         {
             add_scripted_text(1.7f, rm.label());
 
+            _ritual_id = rm.id();
+            curr_bctx().cast_ritual(_ritual_id);
+
             _success_effect = rm.effect();
             _state = battle_screen_state::player_ritual;
             auto time_as_ft(ssvu::getSecondsToFT(rm.time()));
-            _ritual_ctx.set_and_start_minigame(time_as_ft, rm.make());
-            assets().psnd_one(assets().click0);
+            _ritual_ctx.set_and_start_minigame(
+                time_as_ft, rm.make(_ritual_ctx.pool(), curr_bctx().rng()));
+            assets().psnd(assets().click0, sound_priority::high);
         }
 
         void fill_attack_menu()
@@ -1006,7 +1142,7 @@ GGJ16_NAMESPACE
             m.clear();
 
             auto& ps(curr_bctx().player_state());
-            auto& pst(curr_bctx().player().stats());
+            const auto& pst(curr_bctx().player().stats());
 
             ps.for_atk_rituals([this, &pst, &m](auto& rr)
                 {
@@ -1015,7 +1151,8 @@ GGJ16_NAMESPACE
                         {
                             if(rr.req_mana() <= pst.mana())
                             {
-                                pst.mana() -= rr.req_mana();
+                                this->curr_bctx().spend_player_mana(
+                                    rr.req_mana());
                                 this->execute_ritual(rr);
                                 bm.pop_screen();
                             }
@@ -1038,7 +1175,7 @@ GGJ16_NAMESPACE
             m.clear();
 
             auto& ps(curr_bctx().player_state());
-            auto& pst(curr_bctx().player().stats());
+            const auto& pst(curr_bctx().player().stats());
 
             ps.for_utl_rituals([this, &pst, &m](auto& rr)
                 {
@@ -1047,7 +1184,8 @@ GGJ16_NAMESPACE
                         {
                             if(rr.req_mana() <= pst.mana())
                             {
-                                pst.mana() -= rr.req_mana();
+                                this->curr_bctx().spend_player_mana(
+                                    rr.req_mana());
                                 this->execute_ritual(rr);
                                 bm.pop_screen();
                             }
@@ -1096,11 +1234,11 @@ GGJ16_NAMESPACE
 
                     std::ostringstream oss;
                     oss << "Inspecting enemy...\n\n";
-                    oss << "Health: " << es.health() << " / " << es.maxhealth()
-                        << "\n";
-                    oss << "Shield: " << es.shield() << " / " << es.maxshield()
-                        << "\n";
-                    oss << "Power: " << es.power() << "\n";
+                    oss << "Health: " << es.eff_health() << " / "
+                        << es.eff_maxhealth() << "\n";
+                    oss << "Shield: " << es.eff_shield() << " / "
+                        << es.eff_maxshield() << "\n";
+                    oss << "Power: " << es.eff_power() << "\n";
 
                     this->display_msg_box(oss.str());
                 });
@@ -1134,13 +1272,17 @@ GGJ16_NAMESPACE
 
         void ritual_failure()
         {
+            curr_bctx().ritual_outcome(_ritual_id, false);
+
             app()._shake = 40;
             add_scripted_text(1.1f, "Failure!");
-            assets().psnd_one(assets().failure);
+            assets().psnd(assets().failure, sound_priority::high);
         }
         void ritual_success()
         {
-            assets().psnd_one(assets().success);
+            curr_bctx().ritual_outcome(_ritual_id, true);
+
+            assets().psnd(assets().success, sound_priority::high);
             add_scripted_text(1.1f, "Success!");
 
             _success_effect(curr_bctx());
@@ -1153,18 +1295,63 @@ GGJ16_NAMESPACE
             _enemy_stats_gfx.refresh(curr_bctx().enemy().stats());
         }
 
+        /// @brief Refreshes the only bar affected by `e`. Every stat change
+        /// goes through an event, so the HUD needs no per-frame refresh.
+        void refresh_stat_bar(const battle_event& e)
+        {
+            using et = battle_event_type;
+
+            const auto& ps(curr_bctx().player().stats());
+            const auto& es(curr_bctx().enemy().stats());
+
+            switch(e.type())
+            {
+                case et::player_damaged:
+                case et::player_healed:
+                    _player_stats_gfx.refresh_health(ps);
+                    break;
+
+                case et::enemy_damaged:
+                case et::enemy_healed:
+                    _enemy_stats_gfx.refresh_health(es);
+                    break;
+
+                case et::player_shield_damaged:
+                case et::player_shield_healed:
+                    _player_stats_gfx.refresh_shield(ps);
+                    break;
+
+                case et::enemy_shield_damaged:
+                case et::enemy_shield_healed:
+                    _enemy_stats_gfx.refresh_shield(es);
+                    break;
+
+                case et::player_mana_spent:
+                case et::player_mana_restored:
+                    _player_stats_gfx.refresh_mana(ps);
+                    break;
+
+                case et::enemy_mana_restored:
+                    _enemy_stats_gfx.refresh_mana(es);
+                    break;
+
+                default: break;
+            }
+        }
+
 
         void update_menu(ft dt) { _menu_gfx_state.update(app(), _menu, dt); }
         void draw_menu()
         {
             app().render(_bar);
-            _menu_gfx_state.draw(app().window());
+            _menu_gfx_state.draw(app());
         }
 
         void draw_stats_bars()
         {
-            app().render(_player_stats_gfx);
-            app().render(_enemy_stats_gfx);
+            _player_stats_gfx.add_to(app().batch());
+            _enemy_stats_gfx.add_to(app().batch());
+            app().flush_batch();
         }
 
         void update_ritual(ft dt)
@@ -1289,7 +1476,8 @@ GGJ16_NAMESPACE
                             return m_player_name();
                         },
                         be);
-                    assets().psnd_one(assets().enemy_atk0, assets().enemy_atk1);
+                    assets().psnd_one(
+                        curr_bctx().fx_rng(), assets().enemy_atk);
                     break;
 
                 case battle_event_type::enemy_shield_damaged:
@@ -1311,7 +1499,8 @@ GGJ16_NAMESPACE
                         },
                         be);
 
-                    assets().psnd_one(assets().enemy_atk0, assets().enemy_atk1);
+                    assets().psnd_one(
+                        curr_bctx().fx_rng(), assets().enemy_atk);
                     break;
 
                 case battle_event_type::enemy_healed:
@@ -1322,7 +1511,7 @@ GGJ16_NAMESPACE
                         },
                         be);
 
-                    assets().psnd_one(assets().shield_up);
+                    assets().psnd(assets().shield_up, sound_priority::high);
                     break;
 
                 case battle_event_type::player_healed:
@@ -1333,7 +1522,7 @@ GGJ16_NAMESPACE
                         },
                         be);
 
-                    assets().psnd_one(assets().shield_up);
+                    assets().psnd(assets().shield_up, sound_priority::high);
                     break;
 
                 case battle_event_type::enemy_shield_healed:
@@ -1344,7 +1533,7 @@ GGJ16_NAMESPACE
                         },
                         be);
 
-                    assets().psnd_one(assets().shield_up);
+                    assets().psnd(assets().shield_up, sound_priority::high);
                     break;
 
                 case battle_event_type::player_shield_healed:
@@ -1355,7 +1544,7 @@ GGJ16_NAMESPACE
                         },
                         be);
 
-                    assets().psnd_one(assets().shield_up);
+                    assets().psnd(assets().shield_up, sound_priority::high);
                     break;
 
                 case battle_event_type::enemy_stunned:
@@ -1366,21 +1555,25 @@ GGJ16_NAMESPACE
                         },
                         be);
                     break;
+
+                // Already shown by the menu and the ritual minigame.
+                case battle_event_type::player_mana_spent:
+                case battle_event_type::player_mana_restored:
+                case battle_event_type::enemy_mana_restored:
+                case battle_event_type::ritual_cast:
+                case battle_event_type::ritual_outcome: break;
             }
         }
 
         void init_battle()
         {
             auto& battle(curr_bctx().battle());
-            curr_bctx().on_event += [this](auto e)
-            {
-                this->event_listener(e);
-            };
+            begin_battle_log();
 
             // Assume player starts
             if(battle.is_player_turn())
             {
-                _state = battle_screen_state::player_menu;
+                start_player_turn();
             }
             else
             {
@@ -1389,10 +1582,12 @@ GGJ16_NAMESPACE
 
     public:
         battle_screen(game_app& app,
-            std::vector<std::unique_ptr<battle_context_t>>&& ctxs) noexcept
+            std::vector<std::unique_ptr<battle_context_t>>&& ctxs,
+            battle_log::writer& log) noexcept
             : base_type(app),
               _ctxs(std::move(ctxs)),
-              _ritual_ctx{app}
+              _ritual_ctx{app},
+              _log(log)
         {
             init_menu_bg();
             init_cs_text();
@@ -1404,17 +1599,35 @@ GGJ16_NAMESPACE
             app.setup_music(assets().music);
         }
 
+        ~battle_screen()
+        {
+            // Closes a battle left unfinished, so that the log stays
+            // readable.
+            if(!_log.in_battle()) return;
+
+            log_dropped_events();
+            curr_bctx().events().drain([this](const battle_event& e)
+                {
+                    _log.event(e);
+                });
+
+            _log.end(curr_bctx());
+        }
+
         void update(ft dt) override
         {
-            update_stat_bars();
+            GGJ16_PROFILE_SCOPE("battle_screen::update");
+
+            drain_events();
+
             auto f_off(vec2f{0, std::sin(_enemy_f) * _enemy_f_magnitude});
 
             if(_enemy_shake > 0)
             {
                 _enemy_shake -= dt;
                 auto s(std::abs(_enemy_shake));
-                vec2f offset(
-                    ssvu::getRndR(-s, s + 0.1f), ssvu::getRndR(-s, s + 0.1f));
+                auto& rng(curr_bctx().fx_rng());
+                vec2f offset(rng.range(-s, s + 0.1f), rng.range(-s, s + 0.1f));
                 _enemy.setPosition(_esprite_pos + f_off + offset);
 
                 return;
@@ -1452,7 +1665,17 @@ GGJ16_NAMESPACE
             else if(_state == battle_screen_state::enemy_turn)
             {
                 // update_enemy(dt);
-                curr_bctx().enemy_state()._f_ai(*this, curr_bctx());
+                auto& bc(curr_bctx());
+                auto decision(bc.enemy_state()._f_ai(
+                    bc.player().stats(), bc.enemy().stats()));
+
+                display_msg_box(decision._msg);
+                apply_battle_action(bc, decision._action);
+
+                // The message box pauses this screen: react to the attack
+                // (sounds, shake) now, as it shows up.
+                drain_events();
+                end_enemy_turn();
             }
             else if(_state == battle_screen_state::before_enemy_turn)
             {
@@ -1478,25 +1701,30 @@ GGJ16_NAMESPACE
                 else
                 {
                     add_scripted_text(1.7f, "Player turn!");
-                    _state = battle_screen_state::player_menu;
+                    start_player_turn();
                 }
             }
             else if(_state == battle_screen_state::to_next_ctx)
             {
-                ++_ctx_idx;
-                //_enemy.setTexture(*curr_bctx().enemy_state()._enemy_texture);
-                _enemy = sf::Sprite{*curr_bctx().enemy_state()._enemy_texture};
-                _enemy.setScale(vec2f(0.5f, 0.5f));
-                ssvs::setOrigin(_enemy, ssvs::getLocalCenter);
-
-                if(_ctx_idx < 4)
+                if(_ctx_idx + 1 < _ctxs.size())
                 {
+                    ++_ctx_idx;
+                    _seen_dropped = curr_bctx().events().dropped();
+                    update_stat_bars();
+                    _enemy =
+                        curr_bctx().enemy_state()._enemy_region.make_sprite();
+                    _enemy.setScale(vec2f(0.5f, 0.5f));
+                    ssvs::setOrigin(_enemy, ssvs::getLocalCenter);
+
                     display_msg_box("The next demon approaches...");
-                    _state = battle_screen_state::player_menu;
+                    begin_battle_log();
+                    start_player_turn();
                 }
                 else
                 {
+                    // Stay on the last context, which must remain valid.
                     display_msg_box("You won!");
+                    _state = battle_screen_state::game_over;
                 }
             }
             else if(_state == battle_screen_state::to_game_over)
@@ -1512,8 +1740,10 @@ GGJ16_NAMESPACE
 
         void draw() override
         {
-            app().render(_landscape);
-            app().render(_enemy);
+            // Both come from the atlas: a single draw call.
+            app().batch().add(_landscape);
+            app().batch().add(_enemy);
+            app().flush_batch();
 
 
             if(!_scripted_events.empty())
@@ -1541,7 +1771,7 @@ GGJ16_NAMESPACE
         }
     };
 
-    void battle_menu_gfx_button::update(game_app & app, battle_menu & bm, ft dt)
+    void battle_menu_gfx_button::update(game_app & app, battle_menu & bm, ft)
     {
         _shape.setPosition(_pos);
         sf::Color cuh{0, 0, 0, 230};
@@ -1579,11 +1809,7 @@ GGJ16_NAMESPACE
             bm._was_pressed = false;
         }
 
-        _tr.setPosition(_pos + vec2f(5.f, 5.f));
-
-        ssvs::setOrigin(_tr, ssvs::getLocalCenter);
-        _tr.setPosition(ssvs::getGlobalCenter(_shape));
-        _tr.update(dt);
+        _label.setPosition(ssvs::getGlobalCenter(_shape));
     }
 
     struct title_screen : public game_screen
@@ -1595,6 +1821,10 @@ GGJ16_NAMESPACE
 
         sf::Sprite _bg{*assets().title};
 
+        // Shown instead of the prompt until the background assets are in.
+        ssvs::BitmapText _t_loading{mkTxtOBSmall()};
+        int _shown_percent{-1};
+
         std::function<void()> on_start;
         title_screen(game_app& app) : game_screen(app)
         {
@@ -1613,11 +1843,30 @@ GGJ16_NAMESPACE
 
             _t_cs.setScale(vec2f(3.f, 3.f));
             _t_cs2.setScale(vec2f(2.f, 2.f));
+            _t_loading.setScale(vec2f(2.f, 2.f));
+        }
+
+        void update_loading()
+        {
+            auto percent(vrmc::to_int(assets().loading_progress() * 100.f));
+            if(percent == _shown_percent) return;
+
+            _shown_percent = percent;
+            _t_loading.setString(
+                "Loading... " + std::to_string(percent) + "%");
+
+            ssvs::setOrigin(_t_loading, ssvs::getLocalCenter);
+            _t_loading.setPosition(game_constants::width / 2.f,
+                game_constants::height / 2.f + 200.f);
         }
 
         void update(ft dt) override
         {
-            if(_safety >= 0.f)
+            if(!assets().loading_done())
+            {
+                update_loading();
+            }
+            else if(_safety >= 0.f)
             {
                 _safety -= dt;
             }
@@ -1644,377 +1893,76 @@ GGJ16_NAMESPACE
         {
             app().render(_bg);
             // app().render(_t_cs);
-            app().render(_t_cs2);
+
+            if(assets().loading_done())
+                app().render(_t_cs2);
+            else
+                app().render(_t_loading);
         }
     };
 }
 GGJ16_NAMESPACE_END
 
-void fill_ps(ggj16::cplayer_state& ps)
+void fill_ps(
+    ggj16::cplayer_state& ps, const ggj16::ritual_catalogue& rituals)
 {
-    using namespace ggj16;
-
-    ps.emplace_atk_ritual<symbol_ritual>("Fireball",
-        "Easy ritual.\nConnect the dots.\nLow HP damage.\nMinimal shield "
-        "damage.",
-        ritual_type::complete, 4, 15,
-        [](symbol_ritual& sr)
-        {
-            sr.add_point({{-30.f * 2.8f, 60.f * 2.8f}, 10.f});
-            sr.add_point({{0.f * 2.8f, -60.f * 2.8f}, 10.f});
-            sr.add_point({{30.f * 2.8f, 60.f * 2.8f}, 10.f});
-            sr.add_point({{-50.f * 2.8f, -10.f * 2.8f}, 10.f});
-            sr.add_point({{50.f * 2.8f, -10.f * 2.8f}, 10.f});
-        },
-        [](battle_context_t& c)
-        {
-            assets().psnd_one(assets().fireball);
-
-            c.damage_enemy_by(20);
-            c.damage_enemy_shield_by(5);
-        });
-
-    ps.emplace_atk_ritual<aura_ritual>("Rend shield",
-        "Medium ritual.\nPrevent dots from disappearing.\nMinimal HP "
-        "damage.\nLarge shield damage.",
-        ritual_type::resist, 6, 20,
-        [](aura_ritual& sr)
-        {
-            sr.add_point({{-0.f, -45.f * 3.5f}, 20.f});
-            sr.add_point({{-31.f * 2.8f, 31.f * 3.5f}, 20.f});
-            sr.add_point({{31.f * 2.8f, 31.f * 3.5f}, 20.f});
-        },
-        [](battle_context_t& c)
-        {
-            assets().psnd_one(assets().fireball);
-            c.damage_enemy_by(5);
-            c.damage_enemy_shield_by(25);
-        });
-
-    ps.emplace_atk_ritual<symbol_ritual>("Obliterate",
-        "Hard ritual.\nConnect the dots.\nMassive HP damage.\nLow shield "
-        "damage.",
-        ritual_type::complete, 4, 50,
-        [](symbol_ritual& sr)
-        {
-            auto x(-1024 / 2.f);
-            auto y(-768 / 2.f);
-            int x_count = 6;
-            int y_count = 3;
-            auto offset = 40.f;
-
-            auto fullx = game_constants::width - offset * 2;
-            auto fully = game_constants::height - offset * 2;
-
-            auto xinc(fullx / x_count);
-            auto yinc(fully / y_count);
-
-
-            for(int ix = 0; ix < x_count; ++ix)
-            {
-                sr.add_point({{x + offset + xinc * ix, y + offset}, 12.f});
-            }
-
-            for(int iy = 0; iy < y_count + 1; ++iy)
-            {
-                sr.add_point(
-                    {{x + offset + fullx, y + offset + yinc * iy}, 12.f});
-            }
-
-
-            for(int ix = x_count - 1; ix >= 0; --ix)
-            {
-                sr.add_point({{x + offset + xinc * ix,
-                                  y + game_constants::height - offset},
-                    12.f});
-            }
-
-            for(int iy = y_count - 1; iy > 0; --iy)
-            {
-                sr.add_point({{x + offset, y + offset + yinc * iy}, 12.f});
-            }
-        },
-        [](battle_context_t& c)
-        {
-            assets().psnd_one(assets().obliterate);
-            c.damage_enemy_shield_by(20);
-            c.damage_enemy_by(60);
-        });
-
-    ps.emplace_utl_ritual<drag_ritual>("Heal",
-        "Easy ritual.\nCollect the dots.\nMedium HP heal.\nMinimal shield "
-        "self-damage.",
-        ritual_type::complete, 5, 30,
-        [](drag_ritual& sr)
-        {
-            sr.add_target(
-                {game_constants::width / 2.f, game_constants::height / 2.f});
-
-            for(int i = 0; i < 6; ++i)
-            {
-                auto offset(20.f * 2.8f);
-                auto x(ssvu::getRndR(offset, game_constants::width - offset));
-                auto y(ssvu::getRndR(offset, game_constants::height - offset));
-                sr.add_draggable(vec2f{x, y});
-            }
-        },
-        [](battle_context_t& c)
-        {
-            c.damage_player_shield_by(10);
-            c.heal_player_by(35);
-        });
-
-    ps.emplace_utl_ritual<drag_ritual>("Repair shield",
-        "Medium ritual.\nCollect the dots.\nMinimal HP "
-        "self-damage.\nMedium "
-        "shield restoration.",
-        ritual_type::complete, 6, 40,
-        [](drag_ritual& sr)
-        {
-            sr.add_target(
-                {game_constants::width / 2.f, game_constants::height / 2.f});
-
-            for(int i = 0; i < 3; ++i)
-            {
-                auto offset(20.f * 2.8f);
-                sr.add_draggable(vec2f{offset, offset + (i * 60)});
-                sr.add_draggable(
-                    vec2f{game_constants::width - offset, offset + (i * 60)});
-            }
-        },
-        [](battle_context_t& c)
-        {
-            c.damage_player_by(5);
-            c.heal_player_shield_by(25);
-        });
-
-
-    ps.emplace_mana_ritual<aura_ritual>("Restore mana",
-        "Medium ritual.\nRestores your mana.", ritual_type::resist, 4, 0,
-        [](aura_ritual& sr)
-        {
-            auto offset(30.f);
-            //  vec2f center(
-            //       game_constants::width / 2.f, game_constants::height /
-            //       2.f);
-
-            for(int i = -3; i < 4; ++i)
-            {
-                sr.add_point({vec2f{offset * i, offset * i}, 20.f});
-            }
-
-        },
-        [](battle_context_t& c)
-        {
-            assets().psnd_one(assets().shield_up);
-            c.restore_player_mana();
-        });
-}
-
-auto first_ai()
-{
-    using namespace ggj16;
-
-    return [](battle_screen& bs, battle_context_t& bc)
-    {
-        auto& ps(bc.player().stats());
-        auto& es(bc.enemy().stats());
-
-        if(es.health() <= es.maxhealth() * 0.2)
-        {
-            bs.display_msg_box("The demon attempts to heal himself!");
-            bc.heal_enemy_by(10);
-            bc.damage_enemy_shield_by(5);
-        }
-        else
-        {
-            bs.display_msg_box("The demon pounces at the player.");
-            bc.damage_player_by(30);
-            bc.damage_player_shield_by(3);
-        }
-
-        bs.end_enemy_turn();
-    };
+    for(const auto& d : rituals.defs()) ps.add_ritual(d);
 }
 
-auto second_ai()
+int main()
 {
     using namespace ggj16;
 
-    return [](battle_screen& bs, battle_context_t& bc)
-    {
-        auto& ps(bc.player().stats());
-        auto& es(bc.enemy().stats());
+    // Outlives the game, so that battle screens can close their logs.
+    battle_log::writer log_writer{battle_log::timestamped_path("battles")};
 
-        if(es.health() <= es.maxhealth() * 0.3)
-        {
-            bs.display_msg_box("The demon attempts to heal himself!");
-            bc.heal_enemy_by(12);
-            bc.damage_enemy_shield_by(4);
-        }
-        else if(ps.shield() >= ps.maxshield() * 0.8)
-        {
-            bs.display_msg_box("The demon performs\nan armor-piercing attack!");
-            bc.damage_player_shield_by(20);
-            bc.damage_player_by(5);
-        }
-        else
-        {
-            bs.display_msg_box("The demon pounces at the player.");
-            bc.damage_player_by(35);
-            bc.damage_player_shield_by(4);
-        }
-
-        bs.end_enemy_turn();
-    };
-}
-
-auto third_ai()
-{
-    using namespace ggj16;
+    using game_app_runner = boilerplate::app_runner<game_app>;
+    game_app_runner game{
+        "Demon Cleansing", game_constants::width, game_constants::height};
+    game_app& app(game.app());
+#if defined(GGJ16_PROFILE)
+    app.enable_profiler_overlay(*assets().fontObStroked);
+#endif
 
-    return [](battle_screen& bs, battle_context_t& bc)
+    // Textures have to be uploaded from the thread owning the GL context.
+    app.state().onUpdate += [](ft)
     {
-        auto& ps(bc.player().stats());
-        auto& es(bc.enemy().stats());
-
-        if(es.health() <= es.maxhealth() * 0.3)
-        {
-            bs.display_msg_box("The demon attempts to heal himself!");
-            bc.heal_enemy_by(14);
-            bc.damage_enemy_shield_by(3);
-        }
-        else if(es.shield() <= es.maxshield() * 0.2)
-        {
-            bs.display_msg_box("The demon attempts to restore his shield!");
-            bc.heal_enemy_shield_by(10);
-            bc.damage_enemy_by(5);
-        }
-        else if(ps.shield() >= ps.maxshield() * 0.7)
-        {
-            bs.display_msg_box("The demon performs\nan armor-piercing attack!");
-            bc.damage_player_shield_by(25);
-            bc.damage_player_by(7);
-        }
-        else
-        {
-            bs.display_msg_box("The demon pounces at the player.");
-            bc.damage_player_by(40);
-            bc.damage_player_shield_by(5);
-        }
-
-        bs.end_enemy_turn();
+        assets().poll_loading();
     };
-}
 
-auto fourth_ai()
-{
-    using namespace ggj16;
-
-    return [](battle_screen& bs, battle_context_t& bc)
-    {
-        auto& ps(bc.player().stats());
-        auto& es(bc.enemy().stats());
+    cenemy_state es_d0{assets().d0, gauntlet::demon_ai(0)};
+    cenemy_state es_d1{assets().d1, gauntlet::demon_ai(1)};
+    cenemy_state es_d2{assets().d2, gauntlet::demon_ai(2)};
+    cenemy_state es_d3{assets().d3, gauntlet::demon_ai(3)};
 
-        if(es.health() <= es.maxhealth() * 0.3)
+    // Parsed once: casting a ritual only copies its tables.
+    ritual_catalogue rituals{assets().read_data("rituals.json"),
+        [](const std::string& name)
         {
-            bs.display_msg_box("The demon attempts to heal himself!");
-            bc.heal_enemy_by(18);
-            bc.damage_enemy_shield_by(4);
-        }
-        else if(es.shield() <= es.maxshield() * 0.3)
-        {
-            bs.display_msg_box("The demon attempts to restore his shield!");
-            bc.heal_enemy_shield_by(20);
-            bc.damage_enemy_by(5);
-        }
-        else if(ps.shield() >= ps.maxshield() * 0.6)
-        {
-            bs.display_msg_box("The demon performs\nan armor-piercing attack!");
-            bc.damage_player_shield_by(30);
-            bc.damage_player_by(15);
-        }
-        else
-        {
-            bs.display_msg_box("The demon pounces at the player.");
-            bc.damage_player_by(50);
-            bc.damage_player_shield_by(7);
-        }
+            return assets().has_sound(name);
+        }};
 
-        bs.end_enemy_turn();
-    };
-}
-
-int main()
-{
-    using namespace ggj16;
-
-    using game_app_runner = boilerplate::app_runner<game_app>;
-    game_app_runner game{
-        "Demon Cleansing", game_constants::width, game_constants::height};
-    game_app& app(game.app());
-
-    character_stats cs_demon0;
-    cs_demon0.health() = cs_demon0.maxhealth() = 50;
-    cs_demon0.shield() = cs_demon0.maxshield() = 30;
-    cs_demon0.mana() = cs_demon0.maxmana() = 100;
-    cs_demon0.power() = 10;
-
-    character_stats cs_demon1;
-    cs_demon1.health() = cs_demon1.maxhealth() = 60;
-    cs_demon1.shield() = cs_demon1.maxshield() = 35;
-    cs_demon1.mana() = cs_demon1.maxmana() = 200;
-    cs_demon1.power() = 20;
-
-    character_stats cs_demon2;
-    cs_demon2.health() = cs_demon2.maxhealth() = 70;
-    cs_demon2.shield() = cs_demon2.maxshield() = 50;
-    cs_demon2.mana() = cs_demon2.maxmana() = 300;
-    cs_demon2.power() = 30;
-
-    character_stats cs_demon3;
-    cs_demon3.health() = cs_demon3.maxhealth() = 100;
-    cs_demon3.shield() = cs_demon3.maxshield() = 60;
-    cs_demon3.mana() = cs_demon3.maxmana() = 400;
-    cs_demon3.power() = 40;
-
-    character_stats cs_player;
-    cs_player.health() = cs_player.maxhealth() = 100;
-    cs_player.shield() = cs_player.maxshield() = 50;
-    cs_player.mana() = cs_player.maxmana() = 100;
-    cs_player.power() = 100;
-
-    battle_participant demon0{cs_demon0};
-    cenemy_state es_d0{assets().d0};
-    es_d0._f_ai = first_ai();
-
-    battle_participant demon1{cs_demon1};
-    cenemy_state es_d1{assets().d1};
-    es_d1._f_ai = second_ai();
-
-    battle_participant demon2{cs_demon2};
-    cenemy_state es_d2{assets().d2};
-    es_d2._f_ai = third_ai();
-
-    battle_participant demon3{cs_demon3};
-    cenemy_state es_d3{assets().d3};
-    es_d3._f_ai = fourth_ai();
-
-    battle_participant bplayer{cs_player};
     cplayer_state ps;
-    fill_ps(ps);
+    fill_ps(ps, rituals);
 
-    battle_t b0{bplayer, demon0};
-    battle_t b1{bplayer, demon1};
-    battle_t b2{bplayer, demon2};
-    battle_t b3{bplayer, demon3};
+    battle_t b0{gauntlet::make_battle(0)};
+    battle_t b1{gauntlet::make_battle(1)};
+    battle_t b2{gauntlet::make_battle(2)};
+    battle_t b3{gauntlet::make_battle(3)};
 
-    auto battle_set = [=, &app, &ps]() mutable
+    auto battle_set = [=, &app, &ps, &log_writer]() mutable
     {
-        auto bc0(std::make_unique<battle_context_t>(ps, es_d0, b0));
-        auto bc1(std::make_unique<battle_context_t>(ps, es_d1, b1));
-        auto bc2(std::make_unique<battle_context_t>(ps, es_d2, b2));
-        auto bc3(std::make_unique<battle_context_t>(ps, es_d3, b3));
+        // Every battle is reproducible from its context seed.
+        rng_t::seed_type run_seed{std::random_device{}()};
+        auto seed([run_seed](std::uint64_t idx)
+            {
+                return sim::battle_seed(run_seed, idx);
+            });
+
+        auto bc0(std::make_unique<battle_context_t>(ps, es_d0, b0, seed(0)));
+        auto bc1(std::make_unique<battle_context_t>(ps, es_d1, b1, seed(1)));
+        auto bc2(std::make_unique<battle_context_t>(ps, es_d2, b2, seed(2)));
+        auto bc3(std::make_unique<battle_context_t>(ps, es_d3, b3, seed(3)));
 
         std::vector<std::unique_ptr<battle_context_t>> bcs;
         bcs.emplace_back(std::move(bc0));
@@ -2022,7 +1970,8 @@ int main()
         bcs.emplace_back(std::move(bc2));
         bcs.emplace_back(std::move(bc3));
 
-        auto& s_battle(app.make_screen<battle_screen>(std::move(bcs)));
+        auto& s_battle(
+            app.make_screen<battle_screen>(std::move(bcs), log_writer));
 
         s_battle.reset();
         app.push_screen(s_battle);
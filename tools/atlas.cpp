@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base.hpp"
+#include "assets/asset_names.hpp"
+
+// Packs loose textures into power-of-two atlas pages and writes the region
+// index read by `texture_atlas` at startup.
+// Usage: ggj2016_atlas <data dir> [--max=<size>] [--padding=<px>] [names...]
+// Names default to the battle textures; `<name>.png` is read from the data
+// directory. Outputs `atlas<N>.png` and `atlas.json` in the same directory.
+
+namespace atlas
+{
+    using namespace ggj16;
+
+    struct item
+    {
+        std::string _name;
+        sf::Image _image;
+        sz_t _w, _h;
+    };
+
+    struct placement
+    {
+        sz_t _item;
+        sz_t _x, _y;
+    };
+
+    struct shelf
+    {
+        sz_t _y, _h, _x;
+    };
+
+    /// @brief Shelf packing, first-fit: every item goes on the first
+    /// (lowest) shelf it fits on, or opens a new one. `items` must be sorted by
+    /// decreasing height. Returns the items that fit.
+    inline auto pack(const std::vector<item>& items,
+        const std::vector<sz_t>& todo, sz_t w, sz_t h, sz_t padding)
+    {
+        std::vector<placement> result;
+        std::vector<shelf> shelves;
+        sz_t next_y{0};
+
+        for(auto i : todo)
+        {
+            auto iw(items[i]._w + padding);
+            auto ih(items[i]._h + padding);
+
+            auto itr(std::find_if(std::begin(shelves), std::end(shelves),
+                [&](const shelf& s)
+                {
+                    return ih <= s._h && s._x + iw <= w;
+                }));
+
+            if(itr == std::end(shelves))
+            {
+                if(next_y + ih > h || iw > w) continue;
+
+                shelves.push_back({next_y, ih, 0});
+                next_y += ih;
+                itr = std::end(shelves) - 1;
+            }
+
+            result.push_back({i, itr->_x, itr->_y});
+            itr->_x += iw;
+        }
+
+        return result;
+    }
+
+    /// @brief Power-of-two page sizes up to `max`, smallest area first.
+    inline auto page_sizes(sz_t max)
+    {
+        std::vector<std::pair<sz_t, sz_t>> result;
+
+        for(sz_t w(64); w <= max; w *= 2)
+            for(sz_t h(w / 2); h <= w; h *= 2) result.emplace_back(w, h);
+
+        std::stable_sort(std::begin(result), std::end(result),
+            [](const auto& a, const auto& b)
+            {
+                return a.first * a.second < b.first * b.second;
+            });
+
+        return result;
+    }
+
+    struct options
+    {
+        std::string _dir;
+        sz_t _max{2048};
+        sz_t _padding{2};
+        std::vector<std::string> _names;
+    };
+
+    inline auto parse_options(int argc, char** argv)
+    {
+        options o;
+
+        auto value([](const char* arg, const char* key) -> const char*
+            {
+                auto n(std::strlen(key));
+                return std::strncmp(arg, key, n) == 0 ? arg + n : nullptr;
+            });
+
+        for(int i(1); i < argc; ++i)
+        {
+            const char* v;
+
+            if((v = value(argv[i], "--max=")))
+                o._max = std::strtoull(v, nullptr, 10);
+            else if((v = value(argv[i], "--padding=")))
+                o._padding = std::strtoull(v, nullptr, 10);
+            else if(o._dir.empty())
+                o._dir = argv[i];
+            else
+                o._names.emplace_back(argv[i]);
+        }
+
+        if(!o._dir.empty() && o._dir.back() != '/') o._dir += '/';
+
+        if(o._names.empty())
+        {
+            for(auto r : asset_names::regions) o._names.emplace_back(r);
+        }
+
+        return o;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace ggj16;
+    using namespace atlas;
+
+    auto o(parse_options(argc, argv));
+
+    if(o._dir.empty())
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " <data dir> [--max=<size>] [--padding=<px>] [names...]\n";
+        return 1;
+    }
+
+    std::vector<item> items;
+
+    for(const auto& n : o._names)
+    {
+        item it;
+        it._name = n;
+
+        if(!it._image.loadFromFile(o._dir + n + ".png")) return 1;
+
+        it._w = it._image.getSize().x;
+        it._h = it._image.getSize().y;
+        items.emplace_back(std::move(it));
+    }
+
+    std::sort(std::begin(items), std::end(items),
+        [](const item& a, const item& b)
+        {
+            return a._h != b._h ? a._h > b._h : a._w > b._w;
+        });
+
+    std::vector<sz_t> todo(items.size());
+    for(sz_t i(0); i < todo.size(); ++i) todo[i] = i;
+
+    // Only written once every page is saved: the game reads a partial index
+    // as a broken atlas.
+    std::vector<std::string> pages;
+    std::ostringstream index;
+    index << "{\n    \"regions\":\n    [\n";
+
+    bool first{true};
+
+    while(!todo.empty())
+    {
+        // Smallest page that takes every remaining item, or else a full
+        // page with as many as fit.
+        sz_t pw{o._max}, ph{o._max};
+        std::vector<placement> placed;
+
+        for(const auto& s : page_sizes(o._max))
+        {
+            placed = pack(items, todo, s.first, s.second, o._padding);
+            pw = s.first;
+            ph = s.second;
+
+            if(placed.size() == todo.size()) break;
+        }
+
+        if(placed.empty())
+        {
+            std::cerr << "\"" << items[todo.front()]._name
+                      << "\" does not fit in a " << o._max << " page\n";
+            return 1;
+        }
+
+        sf::Image page;
+        page.create(pw, ph, sf::Color::Transparent);
+
+        for(const auto& p : placed)
+        {
+            const auto& it(items[p._item]);
+            page.copy(it._image, p._x, p._y);
+
+            if(!first) index << ",\n";
+            first = false;
+
+            index << "        {\"name\": \"" << it._name                   // .
+                  << "\", \"page\": " << pages.size()                    // .
+                  << ", \"x\": " << p._x << ", \"y\": " << p._y          // .
+                  << ", \"w\": " << it._w << ", \"h\": " << it._h << "}"; // .
+
+            todo.erase(std::find(std::begin(todo), std::end(todo), p._item));
+        }
+
+        auto file("atlas" + std::to_string(pages.size()) + ".png");
+        if(!page.saveToFile(o._dir + file))
+        {
+            std::cerr << "cannot write \"" << file << "\"\n";
+            return 1;
+        }
+
+        std::cout << file << ": " << pw << "x" << ph << ", " << placed.size()
+                  << " textures\n";
+
+        pages.emplace_back(file);
+    }
+
+    index << "\n    ],\n    \"pages\":\n    [\n";
+
+    for(sz_t i(0); i < pages.size(); ++i)
+    {
+        index << "        \"" << pages[i] << "\""
+              << (i + 1 < pages.size() ? "," : "") << "\n";
+    }
+
+    index << "    ]\n}\n";
+
+    std::ofstream os{o._dir + "atlas.json"};
+    os << index.str();
+    return os ? 0 : 1;
+}
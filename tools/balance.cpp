@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "base.hpp"
+#include "battle/battle.hpp"
+#include "battle/gauntlet.hpp"
+#include "sim.hpp"
+
+// Parallel Monte Carlo balance runner for the four-demon gauntlet.
+// Usage: ggj2016_balance [playthroughs] [seed] [threads]
+
+int main(int argc, char** argv)
+{
+    using namespace ggj16;
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    sz_t count{argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000};
+    rng_t::seed_type seed{argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1};
+
+    sim::work_stealing_pool pool{argc > 3
+                                     ? std::strtoull(argv[3], nullptr, 10)
+                                     : std::thread::hardware_concurrency()};
+
+    sim::gauntlet_runner runner;
+
+    auto start(hr_clock::now());
+    auto h(runner.run(pool, count, seed));
+    std::chrono::duration<double> elapsed(hr_clock::now() - start);
+
+    auto completed(double(h._completed) / h._playthroughs);
+    auto throughput(h._playthroughs / elapsed.count());
+
+    std::cout << std::fixed << std::setprecision(3)  // .
+              << "playthroughs: " << h._playthroughs // .
+              << "\tthreads: " << pool.thread_count() // .
+              << "\tcompleted: " << completed         // .
+              << "\tplaythroughs/s: " << throughput   // .
+              << "\n\n";
+
+    for(sz_t d(0); d < gauntlet::demon_count; ++d)
+    {
+        const auto& dh(h._demons[d]);
+
+        std::cout << "demon " << d                                 // .
+                  << "\tfought: " << dh._fought                    // .
+                  << "\twin rate: " << dh.win_rate()               // .
+                  << "\tturns to kill p50/p90: "                   // .
+                  << dh.turns_percentile(0.5) << "/"               // .
+                  << dh.turns_percentile(0.9) << "\n\thp left:";
+
+        for(sz_t i(0); i < dh._hp_left.size(); ++i)
+        {
+            auto ratio(dh._wins == 0 ? 0.0 : double(dh._hp_left[i]) / dh._wins);
+            std::cout << " " << i * dh.hp_bin_width << ":" << ratio;
+        }
+
+        std::cout << "\n\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,379 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "base.hpp"
+#include "battle/battle.hpp"
+#include "battle/gauntlet.hpp"
+#include "sim.hpp"
+
+// Microbenchmarks for the battle core. Inputs use fixed seeds, so results
+// are comparable across commits.
+// Usage: ggj2016_bench [--filter=<substring>] [--min_time=<seconds>]
+//                      [--repetitions=<n>] [--json]
+
+namespace bench
+{
+    using namespace ggj16;
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    /// @brief Prevents the compiler from optimizing away `x`.
+    template <typename T>
+    inline void do_not_optimize(const T& x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(x) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &x;
+#endif
+    }
+
+    /// @brief Passed to every benchmark body, which must run its
+    /// operation `iterations()` times and report how many items it
+    /// processed.
+    class state
+    {
+    private:
+        sz_t _iterations;
+        sz_t _items{0};
+
+    public:
+        state(sz_t iterations) noexcept : _iterations{iterations} {}
+
+        const auto& iterations() const noexcept { return _iterations; }
+
+        auto& items() noexcept { return _items; }
+        const auto& items() const noexcept { return _items; }
+    };
+
+    struct benchmark
+    {
+        std::string _name;
+        std::function<void(state&)> _f;
+    };
+
+    struct result
+    {
+        std::string _name;
+        sz_t _iterations;
+        double _ns_per_iteration;
+        double _items_per_second;
+    };
+
+    struct options
+    {
+        std::string _filter;
+        double _min_time{0.25};
+        sz_t _repetitions{5};
+        bool _json{false};
+    };
+
+    inline double time_run(const benchmark& b, state& s)
+    {
+        auto start(hr_clock::now());
+        b._f(s);
+        std::chrono::duration<double> elapsed(hr_clock::now() - start);
+        return elapsed.count();
+    }
+
+    /// @brief Grows the iteration count until a run lasts `min_time`, then
+    /// reports the median of `repetitions` runs.
+    inline result run(const benchmark& b, const options& o)
+    {
+        sz_t iterations{1};
+
+        while(true)
+        {
+            state s{iterations};
+            auto t(time_run(b, s));
+
+            if(t >= o._min_time || iterations >= (sz_t(1) << 40)) break;
+
+            auto scale(t <= 0 ? 10.0 : std::min(10.0, 1.4 * o._min_time / t));
+            iterations = std::max(iterations + 1, sz_t(iterations * scale));
+        }
+
+        std::vector<double> times;
+        sz_t items{0};
+
+        for(sz_t i(0); i < o._repetitions; ++i)
+        {
+            state s{iterations};
+            times.emplace_back(time_run(b, s));
+            items = s.items();
+        }
+
+        std::sort(std::begin(times), std::end(times));
+        auto median(times[times.size() / 2]);
+
+        return {b._name, iterations, median * 1e9 / iterations,
+            items / median};
+    }
+
+    inline void print_json(const std::vector<result>& rs, const options& o)
+    {
+        std::cout << "{\n  \"context\": {\n"
+                  << "    \"min_time\": " << o._min_time << ",\n"
+                  << "    \"repetitions\": " << o._repetitions << ",\n"
+                  << "    \"simd_width\": "
+                  << sz_t(sim::simd::wide_ops::width)
+                  << "\n  },\n  \"benchmarks\": [\n";
+
+        for(sz_t i(0); i < rs.size(); ++i)
+        {
+            const auto& r(rs[i]);
+
+            std::cout << "    {\"name\": \"" << r._name                 // .
+                      << "\", \"iterations\": " << r._iterations         // .
+                      << ", \"real_time\": " << r._ns_per_iteration      // .
+                      << ", \"time_unit\": \"ns\""                       // .
+                      << ", \"items_per_second\": " << r._items_per_second // .
+                      << "}" << (i + 1 < rs.size() ? "," : "") << "\n";
+        }
+
+        std::cout << "  ]\n}\n";
+    }
+
+    inline void print_table(const std::vector<result>& rs)
+    {
+        std::cout << std::left << std::setw(36) << "benchmark"
+                  << std::right << std::setw(14) << "ns/iter" // .
+                  << std::setw(14) << "iterations"            // .
+                  << std::setw(16) << "items/s"
+                  << "\n";
+
+        for(const auto& r : rs)
+        {
+            std::cout << std::left << std::setw(36) << r._name // .
+                      << std::right << std::setw(14) << r._ns_per_iteration
+                      << std::setw(14) << r._iterations // .
+                      << std::setw(16) << r._items_per_second << "\n";
+        }
+    }
+
+    /// @brief Stat arrays with varied values, generated from a fixed seed.
+    inline auto make_stat_arrays(sz_t n)
+    {
+        rng_t rng{0xB0BA, 0};
+        std::vector<stat_array> result(n);
+
+        for(auto& a : result)
+            for(auto& x : a) x = rng.range(0.f, 200.f);
+
+        return result;
+    }
+
+    inline auto make_buff()
+    {
+        using st = stat_type;
+        namespace se = stat_effects;
+
+        return stat_buff{{st::power, se::mul(1.5f)},
+            {st::power, se::add(5.f)}, {st::maxhealth, se::add(20.f)},
+            {st::shield, se::clamp_max(80.f)},
+            {st::mana, se::clamp_min(10.f)}};
+    }
+
+    inline auto make_benchmarks()
+    {
+        constexpr sz_t data_size{1024};
+        constexpr sz_t data_mask{data_size - 1};
+
+        std::vector<benchmark> result;
+
+        result.push_back({"damage_calc", [](state& s)
+            {
+                battle_context_t ctx{gauntlet::make_battle(0), 1};
+                auto arrays(make_stat_arrays(data_size));
+                std::vector<character_stats> stats;
+                for(const auto& a : arrays) stats.emplace_back(a);
+
+                for(sz_t i(0); i < s.iterations(); ++i)
+                {
+                    auto dmg(ctx.damage_calc(stats[i & data_mask], 20.f));
+                    do_not_optimize(dmg);
+                }
+
+                s.items() = s.iterations();
+            }});
+
+        result.push_back({"stat_buff::compute", [](state& s)
+            {
+                auto buff(make_buff());
+                auto arrays(make_stat_arrays(data_size));
+
+                for(sz_t i(0); i < s.iterations(); ++i)
+                {
+                    auto r(buff.compute(arrays[i & data_mask]));
+                    do_not_optimize(r);
+                }
+
+                s.items() = s.iterations();
+            }});
+
+        result.push_back({"apply_targeted_stat_effect", [](state& s)
+            {
+                targeted_stat_effect e{
+                    stat_type::power, stat_effects::add(3.f)};
+                auto arrays(make_stat_arrays(data_size));
+
+                for(sz_t i(0); i < s.iterations(); ++i)
+                {
+                    auto& a(arrays[i & data_mask]);
+                    apply_targeted_stat_effect(e, a);
+                    do_not_optimize(a);
+
+                    // Keep the values bounded.
+                    a[vrmc::from_enum(stat_type::power)] -= 3.f;
+                }
+
+                s.items() = s.iterations();
+            }});
+
+        // Recording one event per context mutation, then draining them in
+        // batches like the battle screen does once per frame.
+        result.push_back({"battle_event dispatch", [](state& s)
+            {
+                battle_context_t ctx{gauntlet::make_battle(3), 1};
+                ctx.events().enabled() = true;
+
+                constexpr sz_t batch{16};
+                stat_value sum{0};
+
+                for(sz_t i(0); i < s.iterations(); ++i)
+                {
+                    for(sz_t k(0); k < batch; ++k)
+                    {
+                        ctx.heal_player_shield_by(1.f);
+                        ctx.damage_player_shield_by(1.f);
+                    }
+
+                    ctx.events().drain([&sum](const battle_event& e)
+                        {
+                            sum += e.e_heal()._amount;
+                        });
+                }
+
+                do_not_optimize(sum);
+                s.items() = s.iterations() * batch * 2;
+            }});
+
+        result.push_back({"battle_simulator::run", [](state& s)
+            {
+                sim::battle_simulator simulator;
+                auto battle(gauntlet::make_battle(1));
+                auto ai(gauntlet::demon_ai(1));
+
+                for(sz_t i(0); i < s.iterations(); ++i)
+                {
+                    auto r(simulator.run(battle, ai, sim::battle_seed(7, i)));
+                    do_not_optimize(r);
+                }
+
+                s.items() = s.iterations();
+            }});
+
+        result.push_back({"soa_battle_simulator::run_batch/4096",
+            [](state& s)
+            {
+                constexpr sz_t count{4096};
+
+                sim::soa_battle_simulator simulator;
+                auto battle(gauntlet::make_battle(1));
+                auto ai(gauntlet::demon_ai(1));
+
+                for(sz_t i(0); i < s.iterations(); ++i)
+                {
+                    auto r(simulator.run_batch(battle, ai, count, i));
+                    do_not_optimize(r);
+                }
+
+                s.items() = s.iterations() * count;
+            }});
+
+        result.push_back({"kernels::damage_calc/4096", [](state& s)
+            {
+                constexpr sz_t count{4096};
+
+                rng_t rng{0xB0BA, 1};
+                std::vector<float> h(count), sh(count), ms(count), x(count);
+
+                for(sz_t i(0); i < count; ++i)
+                {
+                    ms[i] = rng.range(50.f, 200.f);
+                    sh[i] = rng.range(0.f, ms[i]);
+                    x[i] = rng.range(0.f, 10.f);
+                }
+
+                for(sz_t i(0); i < s.iterations(); ++i)
+                {
+                    // Refill outside of the kernel's dependency chain.
+                    std::fill(std::begin(h), std::end(h), 1e6f);
+                    sim::kernels::damage_calc(
+                        h.data(), sh.data(), ms.data(), x.data(), count);
+                    do_not_optimize(h.data());
+                }
+
+                s.items() = s.iterations() * count;
+            }});
+
+        return result;
+    }
+
+    inline auto parse_options(int argc, char** argv)
+    {
+        options o;
+
+        auto value([](const char* arg, const char* key) -> const char*
+            {
+                auto n(std::strlen(key));
+                return std::strncmp(arg, key, n) == 0 ? arg + n : nullptr;
+            });
+
+        for(int i(1); i < argc; ++i)
+        {
+            const char* v;
+
+            if((v = value(argv[i], "--filter=")))
+                o._filter = v;
+            else if((v = value(argv[i], "--min_time=")))
+                o._min_time = std::strtod(v, nullptr);
+            else if((v = value(argv[i], "--repetitions=")))
+                o._repetitions = std::max(1ull, std::strtoull(v, nullptr, 10));
+            else if(std::strcmp(argv[i], "--json") == 0)
+                o._json = true;
+            else
+                std::cerr << "unknown option: " << argv[i] << "\n";
+        }
+
+        return o;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto o(bench::parse_options(argc, argv));
+    std::vector<bench::result> results;
+
+    for(const auto& b : bench::make_benchmarks())
+    {
+        if(b._name.find(o._filter) == std::string::npos) continue;
+        results.emplace_back(bench::run(b, o));
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    if(o._json)
+        bench::print_json(results, o);
+    else
+        bench::print_table(results);
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "base.hpp"
+#include "assets/asset_names.hpp"
+#include "assets/asset_pack.hpp"
+
+// Builds `assets.pak`, read by the game instead of the loose files in its
+// data directory: see `asset_pack.hpp` for the format.
+// Usage: ggj2016_pack <data dir> [--rle] [--out=<file>]
+// Textures are stored as decoded RGBA pixels, run-length coded with `--rle`.
+// If `ggj2016_atlas` was run, its pages and regions are packed instead of the
+// loose battle textures. Music is streamed, so it stays a loose file.
+// Asset names come from `asset_names.hpp`, like the game's.
+
+namespace pack
+{
+    using namespace ggj16;
+    using namespace ggj16::asset_pack;
+
+    class builder
+    {
+    private:
+        std::string _dir;
+        bool _rle;
+        std::vector<entry> _entries;
+        std::vector<buffer> _blobs;
+
+        auto& add(entry_kind k, const std::string& name, buffer blob)
+        {
+            VRM_CORE_ASSERT_OP(name.size(), <, name_size);
+
+            entry e;
+            std::memset(&e, 0, sizeof(e));
+            std::strncpy(e._name, name.c_str(), name_size - 1);
+            e._kind = k;
+            e._codec = codec::raw;
+            e._size = blob.size();
+
+            _entries.emplace_back(e);
+            _blobs.emplace_back(std::move(blob));
+            return _entries.back();
+        }
+
+        auto index_of(entry_kind k, const std::string& name) const
+        {
+            for(sz_t i(0); i < _entries.size(); ++i)
+                if(_entries[i]._kind == k && name == _entries[i]._name)
+                    return i;
+
+            return _entries.size();
+        }
+
+    public:
+        builder(const std::string& dir, bool rle) : _dir{dir}, _rle{rle} {}
+
+        /// @brief Returns the entry index, or `-1` if `file` is unreadable.
+        /// Textures are only added once.
+        int texture(const std::string& file)
+        {
+            auto existing(index_of(entry_kind::texture, file));
+            if(existing != _entries.size()) return vrmc::to_int(existing);
+
+            sf::Image img;
+            if(!img.loadFromFile(_dir + file)) return -1;
+
+            auto w(img.getSize().x), h(img.getSize().y);
+            auto pixels(img.getPixelsPtr());
+            auto count(sz_t(w) * h);
+
+            buffer raw(pixels, pixels + count * rle::pixel_size);
+            buffer packed;
+            if(_rle) rle::encode(pixels, count, packed);
+
+            // Keep whichever is smaller: noisy images do not compress.
+            auto use_rle(_rle && packed.size() < raw.size());
+
+            auto& e(add(entry_kind::texture, file,
+                use_rle ? std::move(packed) : std::move(raw)));
+            e._codec = use_rle ? codec::rle : codec::raw;
+            e._params[0] = w;
+            e._params[1] = h;
+
+            return vrmc::to_int(_entries.size() - 1);
+        }
+
+        bool file(entry_kind k, const std::string& name,
+            const std::string& path, std::uint32_t param = 0)
+        {
+            std::ifstream is{_dir + path, std::ios::binary};
+            if(!is) return false;
+
+            add(k, name, buffer{std::istreambuf_iterator<char>{is},
+                             std::istreambuf_iterator<char>{}})
+                ._params[0] = param;
+            return true;
+        }
+
+        void region(const std::string& name, std::uint32_t page, int x,
+            int y, int w, int h)
+        {
+            auto& e(add(entry_kind::region, name, buffer{}));
+            e._params[0] = page;
+            e._params[1] = x;
+            e._params[2] = y;
+            e._params[3] = w;
+            e._params[4] = h;
+        }
+
+        bool write(const std::string& path)
+        {
+            auto align([](std::uint64_t x)
+                {
+                    return (x + blob_alignment - 1) / blob_alignment *
+                           blob_alignment;
+                });
+
+            std::uint64_t offset{
+                align(sizeof(header) + _entries.size() * sizeof(entry))};
+
+            for(sz_t i(0); i < _entries.size(); ++i)
+            {
+                _entries[i]._offset = offset;
+                offset = align(offset + _blobs[i].size());
+            }
+
+            header h;
+            std::memcpy(h._magic, magic, magic_size);
+            h._version = version;
+            h._entry_count = _entries.size();
+
+            std::ofstream os{path, std::ios::binary};
+            os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            os.write(reinterpret_cast<const char*>(_entries.data()),
+                _entries.size() * sizeof(entry));
+
+            for(sz_t i(0); i < _entries.size(); ++i)
+            {
+                // Zero padding up to the aligned blob offset.
+                auto pos(std::uint64_t(os.tellp()));
+                std::vector<char> padding(_entries[i]._offset - pos, 0);
+                os.write(padding.data(), padding.size());
+
+                os.write(reinterpret_cast<const char*>(_blobs[i].data()),
+                    _blobs[i].size());
+            }
+
+            std::cout << path << ": " << _entries.size() << " entries, "
+                      << offset << " bytes\n";
+
+            return bool(os);
+        }
+    };
+
+    /// @brief Packs the pages and regions of `atlas.json`. Returns false
+    /// if there is no atlas.
+    inline bool add_atlas(builder& b, const std::string& dir)
+    {
+        if(!std::ifstream{dir + "atlas.json"}) return false;
+
+        auto index(ssvj::fromFile(dir + "atlas.json"));
+        std::vector<int> pages;
+
+        for(const auto& p : index["pages"].forArr())
+        {
+            pages.emplace_back(b.texture(p.as<std::string>()));
+            if(pages.back() < 0) return false;
+        }
+
+        for(const auto& r : index["regions"].forArr())
+        {
+            auto page(r["page"].as<int>());
+            VRM_CORE_ASSERT_OP(page, <, vrmc::to_int(pages.size()));
+
+            b.region(r["name"].as<std::string>(), pages[page],
+                r["x"].as<int>(), r["y"].as<int>(), r["w"].as<int>(),
+                r["h"].as<int>());
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace ggj16;
+    using namespace pack;
+
+    std::string dir, out;
+    bool rle{false};
+
+    for(int i(1); i < argc; ++i)
+    {
+        if(std::strcmp(argv[i], "--rle") == 0)
+            rle = true;
+        else if(std::strncmp(argv[i], "--out=", 6) == 0)
+            out = argv[i] + 6;
+        else
+            dir = argv[i];
+    }
+
+    if(dir.empty())
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " <data dir> [--rle] [--out=<file>]\n";
+        return 1;
+    }
+
+    if(dir.back() != '/') dir += '/';
+    if(out.empty()) out = dir + "assets.pak";
+
+    builder b{dir, rle};
+
+    auto fail([](const std::string& file)
+        {
+            std::cerr << "cannot read \"" << file << "\"\n";
+            return 1;
+        });
+
+    for(std::string f : asset_names::fonts)
+    {
+        auto texture(b.texture(f + ".png"));
+        if(texture < 0) return fail(f + ".png");
+
+        if(!b.file(entry_kind::font, f, f + ".json", texture))
+            return fail(f + ".json");
+    }
+
+    for(std::string t : asset_names::textures)
+        if(b.texture(t) < 0) return fail(t);
+
+    if(!add_atlas(b, dir))
+        for(std::string r : asset_names::regions)
+            if(b.texture(r + ".png") < 0) return fail(r + ".png");
+
+    for(std::string s : asset_names::sounds)
+        if(!b.file(entry_kind::sound, s, s)) return fail(s);
+
+    for(std::string d : asset_names::data_files)
+        if(!b.file(entry_kind::data, d, d)) return fail(d);
+
+    return b.write(out) ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include <array>
+#include <iomanip>
+#include <iostream>
+
+#include "base.hpp"
+#include "battle/battle.hpp"
+#include "battle/battle_log.hpp"
+
+// Replays every battle of a binary battle log, checks that each one ends in
+// the logged state, and prints aggregate statistics.
+// Usage: ggj2016_replay <log file>
+
+int main(int argc, char** argv)
+{
+    using namespace ggj16;
+    using et = battle_event_type;
+
+    if(argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <log file>\n";
+        return 1;
+    }
+
+    auto data(battle_log::load(argv[1]));
+    battle_log::reader r{data};
+
+    sz_t battles{0}, mismatches{0}, lossy{0}, wins{0}, turns{0}, events{0};
+    std::array<sz_t, 256> casts{}, successes{};
+
+    bool matches;
+
+    // State of the battle being replayed, after its latest event.
+    bool won{false};
+    int turn{0};
+
+    auto f_event([&](battle_context_t& ctx, const battle_event& e)
+        {
+            ++events;
+            won = ctx.battle().enemy_dead();
+            turn = ctx.battle().turn();
+
+            if(e.type() == et::ritual_outcome)
+            {
+                auto id(e.e_ritual()._ritual % casts.size());
+                ++casts[id];
+                successes[id] += e.e_ritual()._success;
+            }
+        });
+
+    while(battle_log::replay_next(r, f_event, matches))
+    {
+        ++battles;
+
+        // Battles with lost events are not expected to match.
+        if(r.dropped() != 0)
+            ++lossy;
+        else
+            mismatches += !matches;
+
+        wins += won;
+        turns += turn;
+        won = false;
+        turn = 0;
+    }
+
+    if(!r.valid())
+        std::cerr << "warning: malformed or truncated log, stopped after "
+                  << battles << " battles\n";
+
+    if(lossy != 0)
+        std::cerr << "warning: " << lossy
+                  << " battles lost events before they were logged, and "
+                     "cannot be replayed exactly\n";
+
+    auto avg([battles](double x)
+        {
+            return battles == 0 ? 0.0 : x / battles;
+        });
+
+    std::cout << std::fixed << std::setprecision(3)   // .
+              << "battles: " << battles               // .
+              << "\tmismatches: " << mismatches       // .
+              << "\tevents: " << events               // .
+              << "\tbytes/event: "                    // .
+              << (events == 0 ? 0.0 : double(data.size()) / events) // .
+              << "\nwin rate: " << avg(wins)          // .
+              << "\tavg turns: " << avg(turns) << "\n";
+
+    for(sz_t i(0); i < casts.size(); ++i)
+    {
+        if(casts[i] == 0) continue;
+
+        std::cout << "ritual " << i                                 // .
+                  << "\tcast: " << casts[i]                         // .
+                  << "\tsuccess rate: " << double(successes[i]) / casts[i] // .
+                  << "\n";
+    }
+
+    return mismatches == 0 && r.valid() ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include "base.hpp"
+#include "battle/battle.hpp"
+#include "battle/gauntlet.hpp"
+#include "sim.hpp"
+
+// Headless battle simulator.
+// Usage: ggj2016_sim [battles per demon] [seed] [aos|soa]
+
+template <typename TSimulator>
+void run_gauntlet(
+    TSimulator& simulator, ggj16::sz_t count, ggj16::rng_t::seed_type seed)
+{
+    using namespace ggj16;
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    for(sz_t i(0); i < gauntlet::demon_count; ++i)
+    {
+        auto battle(gauntlet::make_battle(i));
+
+        auto start(hr_clock::now());
+        auto r(simulator.run_batch(battle, gauntlet::demon_ai(i), count,
+            sim::battle_seed(seed, i)));
+        std::chrono::duration<double> elapsed(hr_clock::now() - start);
+
+        std::cout << "demon " << i                                   // .
+                  << "\twin rate: " << r.win_rate()                  // .
+                  << "\tavg turns: " << r.avg_turns()                // .
+                  << "\tavg hp left: " << r.avg_player_health()      // .
+                  << "\tbattles/s: " << r._battles / elapsed.count() // .
+                  << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace ggj16;
+
+    sz_t count{argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000};
+    rng_t::seed_type seed{argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1};
+    bool soa{argc > 3 && std::strcmp(argv[3], "soa") == 0};
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    if(soa)
+    {
+        sim::soa_battle_simulator simulator;
+        run_gauntlet(simulator, count, seed);
+    }
+    else
+    {
+        sim::battle_simulator simulator;
+        run_gauntlet(simulator, count, seed);
+    }
+
+    return 0;
+}